@@ -187,7 +187,7 @@ Alignment Alignment::correctMapping(const Graph& G1, const Graph& G2) {
     return Alignment(A);
 }
 
-vector<uint> Alignment::getMapping() const {
+const vector<uint>& Alignment::getMapping() const {
     return A;
 }
 
@@ -234,24 +234,24 @@ void Alignment::writeEdgeList(Graph const * G1, Graph const * G2, ostream& edgeL
 
 
 uint Alignment::numAlignedEdges(const Graph& G1, const Graph& G2) const {
-    vector<vector<uint> > G1EdgeList;
-    G1.getEdgeList(G1EdgeList);
-    Matrix<MATRIX_UNIT> G2Matrix;
-    G2.getMatrix(G2Matrix);
+    const Matrix<MATRIX_UNIT>& G2Matrix = G2.getMatrix();
 
     uint count = 0;
-    for (const auto& edge: G1EdgeList) {
+    for (const auto& edge: G1.getEdgeList()) {
         uint node1 = edge[0], node2 = edge[1];
-        count += G2Matrix[A[node1]][A[node2]];
+        count += G2Matrix.get(A[node1], A[node2]);
     }
     return count;
 }
 
 int Alignment::numSquaredAlignedEdges(const Graph& G1, const Graph& G2) const {
-    vector<vector<uint> > G1EdgeList;
-    G1.getEdgeList(G1EdgeList);
+#ifdef MULTI_PAIRWISE
+    //the G1 edges are added to the rungs below, so this needs a copy
     Matrix<MATRIX_UNIT> G2Matrix;
     G2.getMatrix(G2Matrix);
+#else
+    const Matrix<MATRIX_UNIT>& G2Matrix = G2.getMatrix();
+#endif
 
 #if 0
     Pseudo-code (assuming you have initially removed g1 from g2)
@@ -266,7 +266,7 @@ int Alignment::numSquaredAlignedEdges(const Graph& G1, const Graph& G2) const {
 #ifdef MULTI_PAIRWISE
     // Before computing rung sizes, we need to add the edges
     // from G1 that we pruned back to G2
-    for (const auto& edge: G1EdgeList) {
+    for (const auto& edge: G1.getEdgeList()) {
         uint hole1 = A[edge[0]];
         uint hole2 = A[edge[1]];
         G2Matrix[hole1][hole2] += 1;
@@ -277,7 +277,7 @@ int Alignment::numSquaredAlignedEdges(const Graph& G1, const Graph& G2) const {
     uint n2 = G2.getNumNodes(); 
     for(uint i = 0; i < n2; i++){
         for(uint j = 0; j < i; j++){
-            int rungs  = G2Matrix[i][j];
+            int rungs  = G2Matrix.get(i, j);
             count += rungs * rungs;
         }
     }
@@ -287,23 +287,75 @@ int Alignment::numSquaredAlignedEdges(const Graph& G1, const Graph& G2) const {
 Graph Alignment::commonSubgraph(const Graph& G1, const Graph& G2) const {
     uint n = G1.getNumNodes();
 
-    vector<vector<uint> > G1EdgeList;
-    G1.getEdgeList(G1EdgeList);
-    Matrix<MATRIX_UNIT> G2Matrix;
-
-    G2.getMatrix(G2Matrix);
+    const Matrix<MATRIX_UNIT>& G2Matrix = G2.getMatrix();
 
     //only add edges preserved by alignment
     vector<vector<uint> > edgeList(0);
-    for (const auto& edge: G1EdgeList) {
+    for (const auto& edge: G1.getEdgeList()) {
         uint node1 = edge[0], node2 = edge[1];
-        if (G2Matrix[A[node1]][A[node2]]) {
+        if (G2Matrix.get(A[node1], A[node2])) {
             edgeList.push_back(edge);
         }
     }
     return Graph(n, edgeList);
 }
 
+static uint findRoot(vector<uint>& parent, uint u) {
+    while (parent[u] != u) {
+        parent[u] = parent[parent[u]];
+        u = parent[u];
+    }
+    return u;
+}
+
+void Alignment::commonConnectedComponents(const Graph& G1, const Graph& G2,
+        vector<vector<uint> >& components, vector<uint>& componentEdges) const {
+    uint n = G1.getNumNodes();
+    const Matrix<MATRIX_UNIT>& G2Matrix = G2.getMatrix();
+    vector<uint> parent(n), size(n, 1);
+    for (uint i = 0; i < n; i++) parent[i] = i;
+    vector<uint> alignedEdgeEnds; //one endpoint of each aligned edge
+    for (const auto& edge: G1.getEdgeList()) {
+        uint node1 = edge[0], node2 = edge[1];
+        if (not G2Matrix.get(A[node1], A[node2])) continue;
+        alignedEdgeEnds.push_back(node1);
+        uint root1 = findRoot(parent, node1), root2 = findRoot(parent, node2);
+        if (root1 == root2) continue;
+        if (size[root1] < size[root2]) swap(root1, root2);
+        parent[root2] = root1;
+        size[root1] += size[root2];
+    }
+
+    //numbered by their smallest node, the order in which Graph finds them
+    vector<uint> index(n, n);
+    vector<vector<uint> > found;
+    for (uint i = 0; i < n; i++) {
+        uint root = findRoot(parent, i);
+        if (index[root] == n) {
+            index[root] = found.size();
+            found.push_back(vector<uint>(0));
+        }
+        found[index[root]].push_back(i);
+    }
+    vector<uint> foundEdges(found.size(), 0);
+    for (uint node : alignedEdgeEnds) {
+        foundEdges[index[findRoot(parent, node)]]++;
+    }
+
+    //sorted by size as Graph sorts its components
+    vector<uint> order(found.size());
+    for (uint i = 0; i < order.size(); i++) order[i] = i;
+    sort(order.begin(), order.end(), [&found](uint a, uint b) {
+        return found[a].size() > found[b].size();
+    });
+    components.clear();
+    componentEdges.clear();
+    for (uint k : order) {
+        components.push_back(move(found[k]));
+        componentEdges.push_back(foundEdges[k]);
+    }
+}
+
 void Alignment::compose(const Alignment& other) {
     for (uint i = 0; i < size(); i++) {
         A[i] = other.A[A[i]];
@@ -39,7 +39,7 @@ public:
     Alignment(const vector<uint>& mapping);
     Alignment(Graph* G1, Graph* G2, const vector<vector<string> >& mapList);
 
-    vector<uint> getMapping() const;
+    const vector<uint>& getMapping() const;
 
     uint& operator[](uint node);
     const uint& operator[](const uint node) const;
@@ -55,6 +55,11 @@ public:
 
     //common subgraph: graph with same nodes as G1, but with only the edges preserved by A
     Graph commonSubgraph(const Graph& G1, const Graph& G2) const;
+    //connected components of the common subgraph and the number of edges of
+    //each, in the order of commonSubgraph(G1, G2).getConnectedComponents(),
+    //found with a union-find pass over the edges of G1 without building it
+    void commonConnectedComponents(const Graph& G1, const Graph& G2,
+        vector<vector<uint> >& components, vector<uint>& componentEdges) const;
 
     void compose(const Alignment& other);
 
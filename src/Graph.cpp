@@ -1,5 +1,11 @@
 #include "Graph.hpp"
+#include "utils/FlatBinary.hpp"
+#include "utils/ContentCache.hpp"
 #include <sstream>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <limits>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/file.h>
@@ -13,6 +19,23 @@ using namespace std;
 
 const int Graph::NODE_TYPE_GENE  = 1;
 const int Graph::NODE_TYPE_MIRNA = 2;
+const uint8_t Graph::INFINITE_DISTANCE;
+
+//bump the version whenever the sections written by serializeGraph change
+static const char GRAPH_CACHE_MAGIC[8] = {'S','A','N','A','G','R','P','H'};
+static const uint32_t GRAPH_CACHE_VERSION = 1;
+#ifdef MULTI_PAIRWISE
+static const uint32_t GRAPH_CACHE_FLAGS = 1;
+#else
+static const uint32_t GRAPH_CACHE_FLAGS = 0;
+#endif
+
+//MULTI_PAIRWISE networks carry an integer value per edge
+#ifdef MULTI_PAIRWISE
+static const bool EDGES_HAVE_VALUES = true;
+#else
+static const bool EDGES_HAVE_VALUES = false;
+#endif
 
 
 Graph& Graph::loadGraph(string name, Graph& g) {
@@ -50,12 +73,21 @@ void Graph::setMaxGraphletSize(double number){
     //Graph::computeGraphletDegreeVectors();
 }
 
+double Graph::getMaxGraphletSize() const {
+    return maxGraphletSize;
+}
+
+uint64_t Graph::contentHash() const {
+    uint64_t h = ContentCache::hash(0, getNumNodes());
+    h = ContentCache::hash(h, edgeList.size());
+    for (const auto& edge : edgeList) {
+        h = ContentCache::hash(h, (uint64_t) edge[0] << 32 | edge[1]);
+    }
+    return h;
+}
+
 void Graph::serializeGraph(Graph& G, string outputName, bool typedNodes, bool locked)
 {
-    bool multi_pairwise = false;
-#if MULTI_PAIRWISE
-    multi_pairwise = true;
-#endif
     string sentinel = "networks/" + outputName + "/autogenerated/" + outputName + ".lock";
     int fd = open(sentinel.c_str(), O_RDWR | O_EXCL | O_CREAT, 744);
 
@@ -67,30 +99,58 @@ void Graph::serializeGraph(Graph& G, string outputName, bool typedNodes, bool lo
             close(fd);
             return;
         }
-        string outName = "networks/" + outputName + "/autogenerated/" + outputName + (typedNodes ? "_TypedNodes" : "_UntypedNodes")
-            + (locked ? "_Locked" : "_Unlocked") + (multi_pairwise ? "_Multi_pairwise" : "_Not_multi_pairwise") + ".bin";
-
-        string tmpName = "/tmp/" + outputName + (typedNodes ? "_TypedNodes" : "_UntypedNodes")
-            + (locked ? "_Locked" : "_Unlocked") + (multi_pairwise ? "_Multi_pairwise" : "_Not_multi_pairwise") + ".bin" + to_string(getpid());
+        string outName = binaryCacheFileName(outputName, typedNodes, locked);
+        string tmpName = outName + to_string(getpid());
 
-        ofstream ofs(tmpName, ofstream::binary | ofstream::out);
+        vector<string> nodeNames(G.nodeNameToIndexMap.size());
+        for (const auto& item : G.nodeNameToIndexMap) {
+            nodeNames[item.second] = item.first;
+        }
+        vector<char> lockedList(G.lockedList.begin(), G.lockedList.end());
+#ifdef MULTI_PAIRWISE
+        vector<MATRIX_UNIT> edgeValues(G.edgeList.size());
+        for (uint i = 0; i < G.edgeList.size(); i++) {
+            edgeValues[i] = G.matrix[G.edgeList[i][0]][G.edgeList[i][1]];
+        }
+#endif
 
-        if (ofs.is_open())
-        {
-            cereal::BinaryOutputArchive oArchive(ofs);
-            oArchive(G);
-            ofs.close();
-            struct stat st;
+        try {
+            FlatBinaryWriter out(tmpName, GRAPH_CACHE_MAGIC, GRAPH_CACHE_VERSION, GRAPH_CACHE_FLAGS);
+            out.writeScalar(G.getNumNodes());
+            out.writeScalar(G.geneCount);
+            out.writeScalar(G.miRNACount);
+            out.writeScalar(G.unlockedGeneCount);
+            out.writeScalar(G.unlockedmiRNACount);
+            out.writeScalar(G.lockedCount);
+            out.writeScalar(G.weightedNumEdges);
+            out.writeNestedVector(G.edgeList);
+            out.writeNestedVector(G.adjLists);
+            out.writeNestedVector(G.connectedComponents);
+            out.writeVector(lockedList);
+            out.writeStrings(G.lockedTo);
+            out.writeVector(G.nodeTypes);
+            out.writeVector(G.geneIndexList);
+            out.writeVector(G.miRNAIndexList);
+            out.writeStrings(nodeNames);
+    #ifdef MULTI_PAIRWISE
+            out.writeVector(edgeValues);
+    #endif
+            out.close();
+        } catch (const runtime_error& e) {
+            //runs detached from the main thread, so a failure only means there is no cache
+            cerr << "Warning: could not write the binary cache of " << outputName << ": " << e.what() << endl;
+            remove(tmpName.c_str());
+            remove(sentinel.c_str());
+            flock(fd, LOCK_UN);
+            close(fd);
+            return;
+        }
 
-            if (stat(outName.c_str(), &st) != 0)
-            {
-                string movecmd = string("mv") + string(" ") + tmpName + string(" ") + outName;
-                (void)system(movecmd.c_str());
-            }
-            else
-            {
-                remove(tmpName.c_str());
-            }
+        //replaces a cache with an older format version, never a valid one written concurrently
+        if (not isBinaryCacheValid(outName)) {
+            rename(tmpName.c_str(), outName.c_str());
+        } else {
+            remove(tmpName.c_str());
         }
 
         remove(sentinel.c_str());
@@ -132,200 +192,171 @@ void Graph::serializeShadow(Graph& G)
     }
 }
 
-void Graph::loadGraphFromBinary(Graph& g, string graphName, string lockFile, bool nodesHaveTypes, bool lockedSameName)
-{
+string Graph::binaryCacheFileName(string graphName, bool typedNodes, bool locked) {
     bool multi_pairwise = false;
 #if MULTI_PAIRWISE
     multi_pairwise = true;
 #endif
+    return "networks/" + graphName + "/autogenerated/" + graphName + (typedNodes ? "_TypedNodes" : "_UntypedNodes")
+        + (locked ? "_Locked" : "_Unlocked") + (multi_pairwise ? "_Multi_pairwise" : "_Not_multi_pairwise")
+        + ".v" + to_string(GRAPH_CACHE_VERSION) + ".bin";
+}
+
+bool Graph::isBinaryCacheValid(string fileName) {
+    return FlatBinaryReader::isValid(fileName, GRAPH_CACHE_MAGIC, GRAPH_CACHE_VERSION);
+}
+
+void Graph::loadGraphFromBinary(Graph& g, string graphName, string lockFile, bool nodesHaveTypes, bool lockedSameName)
+{
     g.nodesHaveTypesEnabled = nodesHaveTypes;
 
     bool locked = lockedSameName || lockFile.size() > 0;
-    ifstream ifs("networks/" + graphName + "/autogenerated/" + graphName + (nodesHaveTypes ? "_TypedNodes" : "_UntypedNodes")
-        + (locked ? "_Locked" : "_Unlocked") + (multi_pairwise ? "_Multi_pairwise" : "_Not_multi_pairwise") + ".bin", ifstream::binary | ifstream::in);
-    if (ifs.is_open()) {
-        cereal::BinaryInputArchive iArchive(ifs);
-        iArchive(g);
-        ifs.close();
+    FlatBinaryReader in(binaryCacheFileName(graphName, nodesHaveTypes, locked), GRAPH_CACHE_MAGIC, GRAPH_CACHE_VERSION);
+    if (in.getFlags() != GRAPH_CACHE_FLAGS) {
+        throw runtime_error("binary cache of " + graphName + " was written by a differently configured build");
+    }
+    uint n                 = in.readScalar<uint>();
+    g.geneCount            = in.readScalar<uint>();
+    g.miRNACount           = in.readScalar<uint>();
+    g.unlockedGeneCount    = in.readScalar<int>();
+    g.unlockedmiRNACount   = in.readScalar<int>();
+    g.lockedCount          = in.readScalar<int>();
+    g.weightedNumEdges     = in.readScalar<int>();
+    g.edgeList             = in.readNestedVector();
+    g.adjLists             = in.readNestedVector();
+    g.connectedComponents  = in.readNestedVector();
+    vector<char> lockedList = in.readVector<char>();
+    g.lockedList           = vector<bool>(lockedList.begin(), lockedList.end());
+    g.lockedTo             = in.readStrings();
+    g.nodeTypes            = in.readVector<int>();
+    g.geneIndexList        = in.readVector<uint>();
+    g.miRNAIndexList       = in.readVector<uint>();
+    vector<string> nodeNames = in.readStrings();
+#ifdef MULTI_PAIRWISE
+    vector<MATRIX_UNIT> edgeValues = in.readVector<MATRIX_UNIT>();
+#endif
+
+    g.nodeNameToIndexMap.clear();
+    g.nodeNameToIndexMap.reserve(n);
+    for (uint i = 0; i < nodeNames.size(); i++) {
+        g.nodeNameToIndexMap[nodeNames[i]] = i;
     }
+    //the matrix is not stored: setting the entries of the edges is cheaper than reading n^2 bits
+    g.matrix = Matrix<MATRIX_UNIT>(n);
+    for (uint i = 0; i < g.edgeList.size(); i++) {
+        uint node1 = g.edgeList[i][0], node2 = g.edgeList[i][1];
+#ifdef MULTI_PAIRWISE
+        g.matrix[node1][node2] = g.matrix[node2][node1] = edgeValues[i];
+#else
+        g.matrix[node1][node2] = g.matrix[node2][node1] = true;
+#endif
+    }
+
     g.name = graphName;
     g.updateUnlockedGeneCount();
     cout << "\t" << g.name << " has been deserialized." << endl;
 }
 
 void Graph::loadFromEdgeListFile(string fin, string graphName, Graph& g, bool nodesHaveTypes) {
-#if 0 // cool C++ count nodes
-    pair<unsigned, unsigned> vecLens = countVecLens(fin);
-    const size_t nodeLen = vecLens.first;
-    const size_t vecLen = vecLens.second;
-    //cout << graphName << ": number of nodes = " << nodeLen << ", number of edges = " << vecLen << endl;
-#else // yucky awk code to count nodes
-    string cmd = "awk '{ for (i=1; i<=NF; ++i) a[tolower($i)]++ } END { print length(a) \" \" NR }' ";
-    cmd += fin;
-    string toParse = exec(cmd);
-    string tmp;
-    stringstream parseSS(toParse);
-    parseSS >> tmp;
-    const size_t nodeLen = atoi(tmp.c_str());
-    parseSS >> tmp;
-    const size_t vecLen = atoi(tmp.c_str());
-    cout << graphName << ": number of nodes = " << nodeLen << ", number of edges = " << vecLen << endl;
-#endif
+    ParsedEdges edges;
+    NameInterner nodes;
+    vector<unsigned char> firstColumn;
+    parseEdgeListFile(fin, EDGES_HAVE_VALUES, edges, nodes, firstColumn);
+    const uint nodeSize = nodes.size();
+    cout << graphName << ": number of nodes = " << nodeSize << ", number of edges = " << edges.endpoints.size()/2 << endl;
+
     g.name = graphName;
     g.geneCount = 0;
     g.miRNACount = 0;
-
-    vector<string> nodes;
-    nodes.reserve(nodeLen);
-    unordered_map<string,uint> nodeName2IndexMap;
-    nodeName2IndexMap.reserve(nodeLen);
-
-    vector<vector<string> > edges;
-    edges.reserve(vecLen);
-    memExactFileParseByLine(edges, fin);
-
-    string node1s;
-    string node2s;
-
-    for(unsigned i = 0; i < vecLen; ++i){
-        node1s = edges[i][0];
-        node2s = edges[i][1];
-
-        if(nodeName2IndexMap.find(node1s) == nodeName2IndexMap.end()){
-            nodeName2IndexMap[node1s] = nodes.size();
-            nodes.push_back(node1s);
-            if(nodesHaveTypes){
-                g.nodeTypes.push_back(Graph::NODE_TYPE_GENE);//"gene");
-                g.geneIndexList.push_back(nodeName2IndexMap[node1s]);
+    if(nodesHaveTypes){
+        //nodes first seen in the first column are genes, the rest miRNAs
+        for (uint i = 0; i < nodeSize; ++i) {
+            if (firstColumn[i] == 0) {
+                g.nodeTypes.push_back(Graph::NODE_TYPE_GENE);
+                g.geneIndexList.push_back(i);
                 ++g.geneCount;
-            }
-        }
-
-       if(nodeName2IndexMap.find(node2s) == nodeName2IndexMap.end()){
-            nodeName2IndexMap[node2s] = nodes.size();
-            nodes.push_back(node2s);
-            if(nodesHaveTypes){
-                g.nodeTypes.push_back(Graph::NODE_TYPE_MIRNA);//"miRNA");
-                g.miRNAIndexList.push_back(nodeName2IndexMap[node2s]);
+            } else {
+                g.nodeTypes.push_back(Graph::NODE_TYPE_MIRNA);
+                g.miRNAIndexList.push_back(i);
                 ++g.miRNACount;
             }
         }
     }
 
+    g.initFromParsedEdges(nodeSize, edges, fin, &nodes);
 #ifdef MULTI_PAIRWISE
-    vector<vector<uint>> edgeList(vecLen, vector<uint> (3));
-#else
-    vector<vector<uint>> edgeList(vecLen, vector<uint> (2));
-#endif
-    stringstream errorMsg;
-    string edgeValue;
-    uint index1;
-    uint index2;
-    unordered_map<string, unordered_map<string, uint>* > adjMatrix;
-
-    for (uint i = 0; i < vecLen; ++i) {
-#ifdef MULTI_PAIRWISE
-        if (edges[i].size() == 2) {
-            edgeValue = '1';
-        }
-        else if (edges[i].size() == 3) {
-            edgeValue = edges[i][2];
-        }
-        else {
-            throw runtime_error("File not in edge-list format: "+fin);
-        }
-#else
-        if (edges[i].size() != 2) {
-            throw runtime_error("File not in edge-list format: "+fin);
-        }
+    for (uint i = 0; i < g.edgeList.size(); ++i) {
+        g.edgeList[i].push_back(edges.values[i]);
+    }
 #endif
-        node1s = edges[i][0];
-        node2s = edges[i][1];
+    // init rest of graph
+    g.lockedList = vector<bool> (nodeSize, false);
+    g.lockedTo = vector<string> (nodeSize, "");
+    g.nodeNameToIndexMap.clear();
+    g.nodeNameToIndexMap.reserve(nodeSize);
+    for (uint i = 0; i < nodeSize; ++i) {
+        g.nodeNameToIndexMap[nodes.name(i)] = i;
+    }
+    if(nodesHaveTypes)
+        g.updateUnlockedGeneCount();
+    g.initConnectedComponents();
+}
 
-        // Detects self-looping edges.
-        if(node1s == node2s) {
-            errorMsg << "self-loops not allowed in file '" << fin << "' node " << node1s << '\n';
+void Graph::initFromParsedEdges(uint numNodes, const ParsedEdges& parsed, const string& fileName,
+        const NameInterner* nodeNames) {
+    const vector<uint>& endpoints = parsed.endpoints;
+    const size_t numEdges = endpoints.size()/2;
+    stringstream errorMsg;
+    matrix = Matrix<MATRIX_UNIT>(numNodes);
+    edgeList = vector<vector<uint> > (numEdges, vector<uint>(2));
+    for (size_t i = 0; i < numEdges; ++i) {
+        uint node1 = endpoints[2*i];
+        uint node2 = endpoints[2*i+1];
+        if (node1 == node2) {
+            if (nodeNames) {
+                errorMsg << "self-loops not allowed in file '" << fileName << "' node " << nodeNames->name(node1) << '\n';
+            } else {
+                errorMsg << "self-loops not allowed, node number " << node1+1 << '\n';
+            }
             throw runtime_error(errorMsg.str().c_str());
         }
-
-        // Detects duplicate edges.
-        unordered_map<string, uint> *adjTo1;
-        if(adjMatrix.count(node1s) == 0)
-            adjMatrix[node1s] = new unordered_map<string, uint>();
-        adjTo1 = adjMatrix.at(node1s);
-
-        unordered_map<string, uint> *adjTo2;
-        if(adjMatrix.count(node2s) == 0)
-            adjMatrix[node2s] = new unordered_map<string, uint>();
-        adjTo2 = adjMatrix.at(node2s);
-
-        if( (adjTo1->count(node2s) != 0) || (adjTo2->count(node1s) != 0) ) {
-            uint dupEdgeLineNum = adjTo1->at(node2s);
-            errorMsg << "duplicate edges not allowed in file\n" <<
-                "\t'" << fin << ":" << dupEdgeLineNum+1 << "' " << node1s << " - " << node2s << '\n' <<
-                "\t'" << fin << ":" << i+1              << "' " << node1s << " - " << node2s << '\n';
+        if (matrix[node1][node2] || matrix[node2][node1]) {
+            if (nodeNames) {
+                //edge lists have one edge per line, so the index of the first copy is its line
+                size_t dup = 0;
+                while (not ((endpoints[2*dup] == node1 and endpoints[2*dup+1] == node2) or
+                            (endpoints[2*dup] == node2 and endpoints[2*dup+1] == node1))) {
+                    dup++;
+                }
+                string name1 = nodeNames->name(node1), name2 = nodeNames->name(node2);
+                errorMsg << "duplicate edges not allowed in file\n" <<
+                    "\t'" << fileName << ":" << dup+1 << "' " << name1 << " - " << name2 << '\n' <<
+                    "\t'" << fileName << ":" << i+1   << "' " << name1 << " - " << name2 << '\n';
+            } else {
+                errorMsg << "duplicate edges not allowed (in either direction), node numbers are " << node1+1 << " " << node2+1 << '\n';
+            }
             throw runtime_error(errorMsg.str().c_str());
-        }else{
-            (*adjTo1)[node2s] = i;
-            (*adjTo2)[node1s] = i;
         }
-
-        index1 = nodeName2IndexMap[node1s];
-        index2 = nodeName2IndexMap[node2s];
-        edgeList[i][0] = index1;
-        edgeList[i][1] = index2;
+        // Note that when MULTI_PAIRWISE is on, the adjacency matrix contains full integers, not just bits.
 #ifdef MULTI_PAIRWISE
-        edgeList[i][2] = stoi(edgeValue);
+        matrix[node1][node2] = matrix[node2][node1] = parsed.values[i];
+#else
+        matrix[node1][node2] = matrix[node2][node1] = true;
 #endif
+        edgeList[i][0] = node1;
+        edgeList[i][1] = node2;
     }
-    for(auto itr : adjMatrix) { delete itr.second; }
-
-    nodes.shrink_to_fit();
-    const size_t nodeSize = nodes.size();
-    g.adjLists = vector<vector<uint> > (nodeSize, vector<uint>(0));
-    g.matrix = Matrix<MATRIX_UNIT>(nodeSize);
-    uint node1;
-    uint node2;
-    const size_t edgeListLen = edgeList.size();
-    edgeList.shrink_to_fit();
-    for(unsigned i = 0; i < edgeListLen; ++i){
-        node1 = edgeList[i][0];
-        node2 = edgeList[i][1];
-
-        if(g.matrix[node1][node2] || g.matrix[node2][node1]) {
-            errorMsg << "duplicate edges not allowed (in either direction), node numbers are " << node1 << " " << node2 << '\n';
-	          //unordered_map<uint,string> index2name = g.getIndexToNodeNameMap();
-	          //errorMsg << "In graph[" << graphName << "]: duplicate edges not allowed (in either direction), node names are " <<
-            //          index2name[node1] << " " << index2name[node2] << '\n';
-            throw runtime_error(errorMsg.str().c_str());
-        }
-
-        if(node1 == node2) {
-          errorMsg << "self-loops not allowed, node number " << node1 << '\n';
-          throw runtime_error(errorMsg.str().c_str());
-        }
-
-        // Note that when MULTI_PAIRWISE is on, the adjacency matrix contains full integers, not just bits.
-        #ifdef MULTI_PAIRWISE
-            g.matrix[node1][node2] = g.matrix[node2][node1] = edgeList[i][2];
-        #else
-            g.matrix[node1][node2] = g.matrix[node2][node1] = true;
-        #endif
-        g.adjLists[node1].push_back(node2);
-        g.adjLists[node2].push_back(node1);
+    //sizing every list exactly from the CSR form avoids the push_back regrowth
+    vector<uint64_t> offsets;
+    vector<uint> neighbors;
+    buildCsr(numNodes, endpoints, offsets, neighbors);
+    adjLists = vector<vector<uint> > (numNodes);
+    for (uint node = 0; node < numNodes; ++node) {
+        adjLists[node].assign(neighbors.begin() + offsets[node], neighbors.begin() + offsets[node+1]);
     }
-    // init rest of graph
-    g.lockedList = vector<bool> (nodeSize, false);
-    g.lockedTo = vector<string> (nodeSize, "");
-    g.nodeNameToIndexMap = nodeName2IndexMap;
-    g.edgeList = edgeList;
-    if(nodesHaveTypes)
-        g.updateUnlockedGeneCount();
-    g.initConnectedComponents();
 }
 
 
-
 //transform format
 void Graph::edgeList2gw(string fin, string fout) {
 
@@ -521,6 +552,18 @@ void Graph::getEdgeList(vector<vector<uint> >& edgeListCopy) const {
     edgeListCopy = edgeList;
 }
 
+const Matrix<MATRIX_UNIT>& Graph::getMatrix() const {
+    return matrix;
+}
+
+const vector<vector<uint> >& Graph::getAdjLists() const {
+    return adjLists;
+}
+
+const vector<vector<uint> >& Graph::getEdgeList() const {
+    return edgeList;
+}
+
 const vector<vector<uint> >& Graph::getConnectedComponents() const {
     return connectedComponents;
 }
@@ -539,103 +582,13 @@ void Graph::setEdgeList(vector<vector<uint> >& edgeListCopy) {
 
 void Graph::loadGwFile(const string& fileName) {
     //this function could be improved to deal with blank lines and comments
-    stringstream errorMsg;
-
-    ifstream infile(fileName.c_str());
-    string line;
-    //ignore header
-    for (int i = 0; i < 4; ++i)
-        getline(infile, line);
-    //read number of nodes
-    int n;
-    if(line == "-2") {
-        getline(infile, line);
-        istringstream iss2(line);
-        (iss2 >> n);
-    } else {
-        n = stoi(line);
-    }
-    if (n <= 0) {
-        errorMsg << "Failed to read node number: " << line << " read as " << n;
-        throw runtime_error(errorMsg.str().c_str());
-    }
-    //read (and ditch) nodes
-    string node;
-    for (int i = 0; i < n; ++i) {
-        getline(infile, line);
-        istringstream iss(line);
-        if (!(iss >> node)) {
-            errorMsg << "Failed to read node " << i << " of " << n << ": " << line << " (" << node << ")";
-            throw runtime_error(errorMsg.str().c_str());
-        }
-    }
-    //read number of edges
-    int m;
-    getline(infile, line);
-    istringstream iss2(line);
-    if (!(iss2 >> m)) {
-        errorMsg << "Failed to read edge number: " << line;
-        throw runtime_error(errorMsg.str().c_str());
-    }
-
-    adjLists = vector<vector<uint> > (n, vector<uint>(0));
-    matrix = Matrix<MATRIX_UNIT>(n);
-#ifdef MULTI_PAIRWISE
-    char dump;
-    uint edgeValue;
-#endif
-    edgeList = vector<vector<uint> > (m, vector<uint>(2));
+    ParsedEdges edges;
+    uint n = parseGwFile(fileName, EDGES_HAVE_VALUES, edges);
+    initFromParsedEdges(n, edges, fileName);
     lockedList = vector<bool> (n, false);
     lockedTo = vector<string> (n, "");
     nodeTypes = vector<int> (n, -1);
-
     geneCount = miRNACount = 0;
-
-    //read edges
-    uint node1;
-    uint node2;
-
-    for (int i = 0; i < m; ++i) {
-        getline(infile, line);
-        istringstream iss(line);
-#ifdef MULTI_PAIRWISE
-        if (!(iss >> node1 >> node2 >> dump >> dump >> dump)) {
-#else
-        if (!(iss >> node1 >> node2)) {
-#endif
-            errorMsg << "Failed to read edge: " << line;
-            throw runtime_error(errorMsg.str().c_str());
-        }
-
-#ifdef MULTI_PAIRWISE
-        if (!(iss >> edgeValue)) {
-            errorMsg << "No edge value: " << line;
-            edgeValue = 1;
-        }
-#endif
-        node1--; node2--; //-1 because of remapping
-
-        if(matrix[node1][node2] || matrix[node2][node1]){
-            errorMsg << "duplicate edges not allowed (in either direction), node numbers are " << node1+1 << " " << node2+1 << '\n';
-	    //errorMsg << "In graph [" << graphName << "]: duplicate edges not allowed (in either direction), node names are " << nodeName2IndexMap[node1+1] << " " << nodeName2IndexMap[node2+1] << '\n';
-            throw runtime_error(errorMsg.str().c_str());
-        }
-        if(node1 == node2) {
-            errorMsg << "self-loops not allowed, node number " << node1+1 << '\n';
-            throw runtime_error(errorMsg.str().c_str());
-        }
-        edgeList[i][0] = node1;
-        edgeList[i][1] = node2;
-
-#ifdef MULTI_PAIRWISE
-        matrix[node1][node2] = matrix[node2][node1] = edgeValue;
-#else
-        matrix[node1][node2] = matrix[node2][node1] = true;
-#endif
-        adjLists[node1].push_back(node2);
-        adjLists[node2].push_back(node1);
-    }
-    infile.close();
     initConnectedComponents();
 }
 
@@ -772,13 +725,14 @@ void Graph::initConnectedComponents() {
 }
 
 uint Graph::numNodeInducedSubgraphEdges(const vector<uint>& subgraphNodes) const {
-    unordered_set<uint> nodeSet(subgraphNodes.begin(), subgraphNodes.end());
+    vector<bool> inSubgraph(getNumNodes(), false);
+    for (uint node : subgraphNodes) inSubgraph[node] = true;
     uint count = 0;
     for (uint i = 0; i < subgraphNodes.size(); i++) {
         uint node1 = subgraphNodes[i];
         for (uint j = 0; j < adjLists[node1].size(); j++) {
             uint node2 = adjLists[node1][j];
-            count += nodeSet.count(node2);
+            count += inSubgraph[node2];
         }
     }
     return count/2;
@@ -815,24 +769,40 @@ Graph Graph::nodeInducedSubgraph(const vector<uint>& nodes) const {
 }
 
 void Graph::printStats(int numConnectedComponentsToPrint, ostream& stream) const {
-    stream << "n    = " << getNumNodes() << endl;
-    stream << "m    = " << getNumEdges() << endl;
-    stream << "#connectedComponents = " << getNumConnectedComponents() << endl;
-    stream << "Largest connectedComponents (nodes, edges) = ";
+    //a component has every edge of its nodes
+    vector<uint> componentEdges;
     for (int i = 0; i < min(numConnectedComponentsToPrint, getNumConnectedComponents()); i++) {
-        const vector<uint>& nodes = getConnectedComponents()[i];
-        Graph H = nodeInducedSubgraph(nodes);
-        stream << "(" << H.getNumNodes() << ", " << H.getNumEdges() << ") ";
+        uint degreeSum = 0;
+        for (uint node : getConnectedComponents()[i]) degreeSum += adjLists[node].size();
+        componentEdges.push_back(degreeSum/2);
+    }
+    printStats(getNumNodes(), getNumEdges(), getConnectedComponents(), componentEdges,
+        numConnectedComponentsToPrint, stream);
+}
+
+void Graph::printStats(uint numNodes, uint numEdges, const vector<vector<uint> >& components,
+        const vector<uint>& componentEdges, int numConnectedComponentsToPrint, ostream& stream) {
+    stream << "n    = " << numNodes << endl;
+    stream << "m    = " << numEdges << endl;
+    stream << "#connectedComponents = " << components.size() << endl;
+    stream << "Largest connectedComponents (nodes, edges) = ";
+    for (int i = 0; i < min(numConnectedComponentsToPrint, (int) components.size()); i++) {
+        stream << "(" << components[i].size() << ", " << componentEdges[i] << ") ";
     }
     stream << endl;
 }
 
-void Graph::getDistanceMatrix(vector<vector<short> >& dist) const {
+void Graph::getDistanceMatrix(DistanceMatrix& dist) const {
 #if USE_CACHED_FILES
 // By default, USE_CACHED_FILES is 0 and SANA does not cache files. Change USE_CACHED_FILES at your own risk.
-    string distMatrixFile = "networks/"+name+"/autogenerated/"+name+"_distMatrix.txt";
+    string distMatrixFile = "networks/"+name+"/autogenerated/"+name+"_distMatrix.bin";
     if (fileExists(distMatrixFile)) {
-        readMatrixFromFile(dist, getNumNodes(), getNumNodes(), distMatrixFile);
+        uint n = getNumNodes();
+        dist = DistanceMatrix(n, n);
+        ifstream fin(distMatrixFile.c_str(), ios::in | ios::binary);
+        for (uint i = 0; i < n; i++) {
+            fin.read((char*) &dist[i][0], n);
+        }
         return;
     }
 #endif
@@ -843,33 +813,83 @@ void Graph::getDistanceMatrix(vector<vector<short> >& dist) const {
     cout << "Graph::getDistanceMatrix done (" << T.elapsedString() << ")" << endl;
 #if USE_CACHED_FILES
 // By default, USE_CACHED_FILES is 0 and SANA does not cache files. Change USE_CACHED_FILES at your own risk.
-    writeMatrixToFile(dist, distMatrixFile);   
+    ofstream fout(distMatrixFile.c_str(), ios::out | ios::binary);
+    for (uint i = 0; i < getNumNodes(); i++) {
+        fout.write((const char*) &dist[i][0], getNumNodes());
+    }
 #endif
 }
 
-//a -1 indicates that the distance is infinite
-//floyd-warshall algorithm
-void Graph::computeDistanceMatrix(vector<vector<short> >& dist) const {
-    uint n = getNumNodes();
-    dist = vector<vector<short> > (n, vector<short> (n, -1));
-    assert(false); // replace this with iterated Dijkstra, which is MUCH faster on sparse graphs
+//Each pass runs the BFS of 64 sources at once: bit k of the words of a node
+//tells whether the k-th source has reached it. A level is a pull over the
+//adjacency: a node joins the next frontier of every source that has one of its
+//neighbors in the current frontier and had not reached it yet.
+void Graph::computeDistanceMatrix(DistanceMatrix& dist) const {
+    const uint n = getNumNodes();
+    dist = DistanceMatrix(n, n);
+
+    //CSR copy of adjLists, scanned once per level of every pass
+    vector<uint> offsets(n+1, 0);
+    for (uint v = 0; v < n; v++) offsets[v+1] = offsets[v] + adjLists[v].size();
+    vector<uint> neighbors(offsets[n]);
     for (uint v = 0; v < n; v++) {
-        dist[v][v] = 0;
-        for (uint i = 0; i < adjLists[v].size(); i++) {
-            uint u = adjLists[v][i];
-            dist[u][v] = 1;
-        }
-    }
-    for (uint k = 0; k < n; k++) {
-        for (uint i = 0; i < n; i++) {
-            for (uint j = 0; j < n; j++) {
-                if (dist[i][k] != -1 and dist[k][j] != -1) {
-                    if (dist[i][j] == -1 or dist[i][j] > dist[i][k] + dist[k][j]) {
-                        dist[i][j] = dist[i][k] + dist[k][j];
+        copy(adjLists[v].begin(), adjLists[v].end(), neighbors.begin() + offsets[v]);
+    }
+
+    const uint BATCH = 64;
+    atomic<uint> nextBatch(0);
+    atomic<bool> tooFar(false);
+    auto worker = [&]() {
+        vector<uint64_t> visited(n), frontier(n), next(n);
+        for (uint first = BATCH * nextBatch++; first < n; first = BATCH * nextBatch++) {
+            const uint count = min(BATCH, n - first);
+            const uint64_t all = count == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << count) - 1;
+            fill(visited.begin(), visited.end(), 0);
+            fill(frontier.begin(), frontier.end(), 0);
+            for (uint k = 0; k < count; k++) {
+                uint8_t* row = &dist[first+k][0];
+                fill(row, row + n, INFINITE_DISTANCE);
+                row[first+k] = 0;
+                visited[first+k] |= (uint64_t) 1 << k;
+                frontier[first+k] |= (uint64_t) 1 << k;
+            }
+            for (uint d = 1; ; d++) {
+                bool grew = false;
+                for (uint v = 0; v < n; v++) {
+                    uint64_t reach = 0;
+                    if (visited[v] != all) {
+                        for (uint e = offsets[v]; e < offsets[v+1]; e++) reach |= frontier[neighbors[e]];
+                        reach &= ~visited[v];
+                    }
+                    next[v] = reach;
+                    if (reach == 0) continue;
+                    grew = true;
+                    visited[v] |= reach;
+                    if (d >= INFINITE_DISTANCE) {
+                        tooFar = true;
+                        continue;
+                    }
+                    for (uint64_t bits = reach; bits; bits &= bits - 1) {
+                        dist[first + __builtin_ctzll(bits)][v] = d;
                     }
                 }
+                if (not grew) break;
+                frontier.swap(next);
             }
         }
+    };
+    uint numThreads = max(1u, thread::hardware_concurrency());
+    vector<thread> threads;
+    for (uint t = 1; t < numThreads; t++) {
+        threads.push_back(thread(worker));
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (tooFar) {
+        throw runtime_error("network "+name+" has distances over "+to_string(INFINITE_DISTANCE-1)+
+            ", which the distance matrix cannot hold");
     }
 }
 
@@ -972,6 +992,81 @@ vector<uint> Graph::numEdgesAround(uint node, uint maxDist) const {
     return result;
 }
 
+uint Graph::NeighborhoodProfiles::nodesWithin(uint v, uint d) const {
+    uint res = 0;
+    for (uint i = 0; i <= d; i++) res += nodesAt(v, i);
+    return res;
+}
+
+uint Graph::NeighborhoodProfiles::edgesWithin(uint v, uint d) const {
+    uint res = 0;
+    for (uint i = 0; i < d; i++) res += edgesAt(v, i);
+    return res + sameLevel[v*(depth+1)+d];
+}
+
+void Graph::reserveNeighborhoodDepth(uint depth) {
+    reservedNeighborhoodDepth = max(reservedNeighborhoodDepth, depth);
+}
+
+const Graph::NeighborhoodProfiles& Graph::getNeighborhoodProfiles(uint depth) {
+    if (hasNeighborhoodProfiles and neighborhoodProfiles.depth >= depth) {
+        return neighborhoodProfiles;
+    }
+    depth = max(depth, reservedNeighborhoodDepth);
+    const uint n = getNumNodes();
+    const uint width = depth+1;
+    NeighborhoodProfiles& P = neighborhoodProfiles;
+    P.depth = depth;
+    P.nodes.assign((size_t) n * width, 0);
+    P.sameLevel.assign((size_t) n * width, 0);
+    P.nextLevel.assign((size_t) n * width, 0);
+
+    atomic<uint> nextSource(0);
+    auto worker = [&]() {
+        //scratch reused by all the BFS of this thread; only the nodes in the
+        //queue are reset after each one
+        const uint UNSEEN = numeric_limits<uint>::max();
+        vector<uint> dist(n, UNSEEN);
+        vector<uint> queue;
+        queue.reserve(n);
+        for (uint source = nextSource++; source < n; source = nextSource++) {
+            uint* nodes = &P.nodes[(size_t) source * width];
+            uint* sameLevel = &P.sameLevel[(size_t) source * width];
+            uint* nextLevel = &P.nextLevel[(size_t) source * width];
+            queue.clear();
+            queue.push_back(source);
+            dist[source] = 0;
+            for (uint head = 0; head < queue.size(); head++) {
+                uint u = queue[head];
+                uint d = dist[u];
+                nodes[d]++;
+                //the last level is only counted; scanning its edges is most of the work
+                if (d == depth) continue;
+                for (uint w : adjLists[u]) {
+                    if (dist[w] == UNSEEN) {
+                        dist[w] = d+1;
+                        queue.push_back(w);
+                    }
+                    if (dist[w] == d+1) nextLevel[d]++;
+                    else if (dist[w] == d and u < w) sameLevel[d]++;
+                }
+            }
+            for (uint u : queue) dist[u] = UNSEEN;
+        }
+    };
+    uint numThreads = max(1u, thread::hardware_concurrency());
+    vector<thread> threads;
+    for (uint t = 1; t < numThreads; t++) {
+        threads.push_back(thread(worker));
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+    hasNeighborhoodProfiles = true;
+    return neighborhoodProfiles;
+}
+
 uint Graph::randomNode() {
     return randInt(0, getNumNodes()-1);
 }
@@ -1069,7 +1164,36 @@ string Graph::autogenFilesFolder() {
     return "networks/"+name+"/autogenerated/";
 }
 
+static const char GDV_CACHE_MAGIC[8] = {'S','A','N','A','G','D','V','S'};
+static const uint32_t GDV_CACHE_VERSION = 1;
+
 vector<vector<uint> > Graph::loadGraphletDegreeVectors() {
+    string cacheFileName;
+    if (ContentCache::isEnabled()) {
+        uint64_t key = ContentCache::hash(contentHash(), (uint64_t) maxGraphletSize);
+        cacheFileName = ContentCache::entryFileName("gdv", key);
+        if (FlatBinaryReader::isValid(cacheFileName, GDV_CACHE_MAGIC, GDV_CACHE_VERSION)) {
+            FlatBinaryReader in(cacheFileName, GDV_CACHE_MAGIC, GDV_CACHE_VERSION);
+            vector<vector<uint> > gdvs = in.readNestedVector();
+            if (gdvs.size() == getNumNodes()) return gdvs;
+        }
+    }
+    if (cacheFileName != "") {
+        //the files named after the network are not used, as nothing tells if
+        //they still match it
+        cout << "Computing " << cacheFileName << " ... ";
+        Timer T;
+        T.start();
+        vector<vector<uint> > gdvs = computeGraphletDegreeVectors();
+        cout << "Graph::loadGraphletDegreeVectors done (" << T.elapsedString() << ")" << endl;
+        ContentCache::store(cacheFileName, [&gdvs](const string& tmpName) {
+            FlatBinaryWriter out(tmpName, GDV_CACHE_MAGIC, GDV_CACHE_VERSION);
+            out.writeNestedVector(gdvs);
+            out.close();
+        });
+        return gdvs;
+    }
+
     std::ostringstream oss;
     oss << Graph::maxGraphletSize;
     string gdvsFileName = autogenFilesFolder() + name + "_gdv"+oss.str()+".bin";
@@ -1097,23 +1221,27 @@ vector<vector<uint> > Graph::loadGraphletDegreeVectors() {
 
 vector<vector<uint> > Graph::computeGraphletDegreeVectors() {
     std::cout<<"Computing Graphlet Degree Vectors... "<<endl;
-    uint n = getNumNodes();
-    uint m = getNumEdges();
-
-
-    string fileName = "tmp/compute_dgvs.txt";
-    ofstream fout(fileName.c_str());
-    fout << n << " " << m << endl;
-    for (uint i = 0; i < m; i++) {
-        fout << edgeList[i][0] << " " << edgeList[i][1] << endl;
-    }
-    fout.close();
     double GraphletSizemax = Graph::maxGraphletSize;
 
-    vector<vector<uint> > gdvs = computeGraphlets(GraphletSizemax, fileName);
+    vector<vector<uint> > gdvs = computeGraphlets(GraphletSizemax, getNumNodes(), edgeList);
     return gdvs;
 }
 
+void Graph::loadGraphletDegreeVectors(Graph& G1, Graph& G2,
+        vector<vector<uint> >& gdvs1, vector<vector<uint> >& gdvs2) {
+    if (G1.name == G2.name) {
+        //both would write the same autogenerated files; the second one just reads them
+        gdvs1 = G1.loadGraphletDegreeVectors();
+        gdvs2 = G2.loadGraphletDegreeVectors();
+        return;
+    }
+    future<vector<vector<uint> > > future1 = async(launch::async, [&G1]() {
+        return G1.loadGraphletDegreeVectors();
+    });
+    gdvs2 = G2.loadGraphletDegreeVectors();
+    gdvs1 = future1.get();
+}
+
 unordered_map<string,uint> Graph::getNodeNameToIndexMap() const {
     if(nodeNameToIndexMap.size() != 0){
       return nodeNameToIndexMap;
@@ -1188,15 +1316,16 @@ vector<uint> Graph::degreeDistribution() const {
 }
 
 double Graph::getAverageDistance() const {
-    vector<vector<short> > dists;
+    DistanceMatrix dists;
     getDistanceMatrix(dists);
     uint n = getNumNodes();
     double distSum = 0;
     double distCount = 0;
     for (uint i = 0; i < n; i++) {
         for (uint j = i+1; j < n; j++) {
-            if (dists[i][j] > 0) {
-                distSum += dists[i][j];
+            uint8_t d = dists.get(i, j);
+            if (d > 0 and d != INFINITE_DISTANCE) {
+                distSum += d;
                 distCount++;
             }
         }
@@ -23,6 +23,7 @@
 #include "utils/Timer.hpp"
 #include "computeGraphlets.hpp"
 #include "utils/Matrix.hpp"
+#include "utils/GraphFileParser.hpp"
 
 
 using namespace std;
@@ -35,14 +36,19 @@ public:
     static const int NODE_TYPE_MIRNA; // = 2;
 
     void setMaxGraphletSize(double number);
+    double getMaxGraphletSize() const;
     static Graph& loadGraph(string name, Graph& g);
     static Graph& loadGraphFromPath(string path, string name, Graph& g, bool nodesHaveTypes = false);
     static Graph& multGraph(string name, uint path, Graph& g);
 
     static void loadFromEdgeListFile(string fin, string graphName, Graph& g, bool nodesHaveTypes = false);
 	
+    //the binary cache is a versioned flat file (see FlatBinary.hpp) that is
+    //mapped and copied into the graph in bulk instead of being parsed
     static void loadGraphFromBinary(Graph& g, string graphName, string lockFile, bool nodesHaveTypes, bool lockedSameName);
     static void serializeGraph(Graph& G, string outputName, bool typedNodes, bool locked);
+    static string binaryCacheFileName(string graphName, bool typedNodes, bool locked);
+    static bool isBinaryCacheValid(string fileName);
     void serializeShadow(Graph& G);
 
     static void saveInGWFormat(string outputFile, const vector<string>& nodeNames,
@@ -69,16 +75,23 @@ public:
     uint getWeightedNumEdges();
 #endif
     uint getNumEdges() const;
+    //hash of the number of nodes and the edge list, to key cached results
+    uint64_t contentHash() const;
     const vector<vector<uint> >& getConnectedComponents() const;
     uint getNumConnectedComponents() const;
 
 #ifndef NO_ADJ_MATRIX
     void getMatrix(Matrix<MATRIX_UNIT>& matrix) const;
     void setMatrix(Matrix<MATRIX_UNIT>& matrix);
+    //the graph's own matrix, not a copy; read it with get()
+    const Matrix<MATRIX_UNIT>& getMatrix() const;
 #endif
 
     void getAdjLists(vector<vector<uint> >& adjListsCopy) const;
     void getEdgeList(vector<vector<uint> > & edgeListCopy) const;
+    //the graph's own lists, not copies; valid until the graph is changed
+    const vector<vector<uint> >& getAdjLists() const;
+    const vector<vector<uint> >& getEdgeList() const;
 
     void setAdjLists(vector<vector<uint> >& adjListsCopy);
     void setEdgeList(vector<vector<uint> >& edgeListCopy);
@@ -99,7 +112,34 @@ public:
     vector<uint> numEdgesAround(uint node, uint maxDist) const;
     vector<uint> numNodesAround(uint node, uint maxDist) const;
 
+    //For every node v, what a BFS from v up to distance depth sees: the number
+    //of nodes at each distance d <= depth, and for d < depth the number of
+    //edges joining two nodes at distance d (sameLevel) or a node at d to one
+    //at d+1 (nextLevel). These are all the nodec, edgec, noded and edged
+    //measures need.
+    struct NeighborhoodProfiles {
+        uint depth = 0;
+        vector<uint> nodes, sameLevel, nextLevel; //n rows of depth+1 counts
+
+        uint nodesAt(uint v, uint d) const { return nodes[v*(depth+1)+d]; }
+        //edges whose nearer endpoint is at distance d, d < depth
+        uint edgesAt(uint v, uint d) const { return sameLevel[v*(depth+1)+d] + nextLevel[v*(depth+1)+d]; }
+        //nodes and edges with every endpoint at distance at most d (d < depth for edges)
+        uint nodesWithin(uint v, uint d) const;
+        uint edgesWithin(uint v, uint d) const;
+    };
+    //computed on first use with a parallel BFS from every node, and again
+    //only if a larger depth is asked for
+    const NeighborhoodProfiles& getNeighborhoodProfiles(uint depth);
+    //makes the first computation go at least this deep, so that measures
+    //needing different depths share it
+    void reserveNeighborhoodDepth(uint depth);
+
     void printStats(int numConnectedComponentsToPrint, ostream& stream) const;
+    //the same for a graph given by its size and its connected components,
+    //largest first, with the number of edges of each
+    static void printStats(uint numNodes, uint numEdges, const vector<vector<uint> >& components,
+        const vector<uint>& componentEdges, int numConnectedComponentsToPrint, ostream& stream);
 
     void writeGraphEdgeListFormat(const string& fileName);
     void writeGraphEdgeListFormatNETAL(const string& fileName);
@@ -112,12 +152,20 @@ public:
 
     uint randomNode();
 
+    //from the content cache if it is enabled, otherwise from the autogenerated
+    //files of the network, computing and saving them if they are missing
     vector<vector<uint> > loadGraphletDegreeVectors();
+    //same for both graphs, computing them concurrently
+    static void loadGraphletDegreeVectors(Graph& G1, Graph& G2,
+        vector<vector<uint> >& gdvs1, vector<vector<uint> >& gdvs2);
 
     unordered_map<string,uint> getNodeNameToIndexMap() const;
     unordered_map<uint,string> getIndexToNodeNameMap() const;
 
-    void getDistanceMatrix(vector<vector<short> >& dist) const;
+    //distance between every pair of nodes, INFINITE_DISTANCE if there is no path
+    typedef FlatMatrix<uint8_t> DistanceMatrix;
+    static const uint8_t INFINITE_DISTANCE = 255;
+    void getDistanceMatrix(DistanceMatrix& dist) const;
 
     vector<uint> degreeDistribution() const;
 
@@ -174,6 +222,10 @@ private:
 #endif
     vector<vector<uint> > adjLists; //neighbors in no particular order
 
+    NeighborhoodProfiles neighborhoodProfiles;
+    bool hasNeighborhoodProfiles = false;
+    uint reservedNeighborhoodDepth = 0;
+
     //list of the nodes of each connected component, sorted from larger to smaller
     vector<vector<uint> > connectedComponents;
     //int maxsize;
@@ -192,6 +244,11 @@ private:
 
     void initConnectedComponents();
 
+    //fills the matrix, adjLists and edgeList from parsed edges, rejecting
+    //self-loops and duplicates; nodeNames, if given, is used for the error messages
+    void initFromParsedEdges(uint numNodes, const ParsedEdges& edges, const string& fileName,
+        const NameInterner* nodeNames = nullptr);
+
     void addEdge(uint node1, uint node2);
     void addRandomEdge();
     void removeRandomEdge();
@@ -199,8 +256,8 @@ private:
     string autogenFilesFolder();
     vector<vector<uint> > computeGraphletDegreeVectors();
 
-    //places in dist a matrix with the distance between every pair of nodes (a -1 indicates infinity)
-    void computeDistanceMatrix(vector<vector<short> >& dist) const;
+    //BFS from every node, 64 sources at a time, on all cores
+    void computeDistanceMatrix(DistanceMatrix& dist) const;
 
     //serialization
     friend class cereal::access;
@@ -29,8 +29,12 @@ vector<string> defaultArguments = {
 "-combinedScoreAs sum",
 "-sec 0",
 "-maxGraphletSize 5",
+"-simBits 32",
 "-paretoInitial 1",
 "-paretoCapacity 200",
 "-paretoIterations 10000",
-"-paretoThreads 1"
+"-paretoThreads 1",
+"-threads 1",
+"-replicas max",
+"-exchangeiterations 1000000"
 };
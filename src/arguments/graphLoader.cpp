@@ -148,10 +148,6 @@ void initGraphs(Graph& G1, Graph& G2, ArgumentParser& args) {
     }
     
 #if USE_CACHED_FILES
-    bool multi_pairwise = false;
-#if MULTI_PAIRWISE
-    multi_pairwise = true;
-#endif
     bool lockExists = false;
 // By default, USE_CACHED_FILES is 0 and SANA does not cache files. Change USE_CACHED_FILES at your own risk.
     string g1LockDir = "networks/" + g1Name + "/autogenerated/" + g1Name + ".lock";
@@ -178,29 +174,25 @@ void initGraphs(Graph& G1, Graph& G2, ArgumentParser& args) {
     if (fg1 == "")
     {
         string gw = "networks/"+g1Name+"/"+g1Name+".gw";
-        string bin = "networks/" + g1Name + "/autogenerated/" + g1Name + (args.bools["-nodes-have-types"] ? "_TypedNodes" : "_UntypedNodes")
-        + (usingLocks ? "_Locked" : "_Unlocked") + (multi_pairwise ? "_Multi_pairwise" : "_Not_multi_pairwise") + ".bin";
-        updateG1 = newerGraphAvailable(gw.c_str(), bin.c_str());
+        string bin = Graph::binaryCacheFileName(g1Name, args.bools["-nodes-have-types"], usingLocks);
+        updateG1 = newerGraphAvailable(gw.c_str(), bin.c_str()) or not Graph::isBinaryCacheValid(bin);
     }
     else
     {
-        string bin = "networks/" + g1Name + "/autogenerated/" + g1Name + (args.bools["-nodes-have-types"] ? "_TypedNodes" : "_UntypedNodes") 
-        + (usingLocks ? "_Locked" : "_Unlocked") + (multi_pairwise ? "_Multi_pairwise" : "_Not_multi_pairwise") + ".bin";
-        updateG1 = newerGraphAvailable(fg1.c_str(), bin.c_str());
+        string bin = Graph::binaryCacheFileName(g1Name, args.bools["-nodes-have-types"], usingLocks);
+        updateG1 = newerGraphAvailable(fg1.c_str(), bin.c_str()) or not Graph::isBinaryCacheValid(bin);
     }
 	
     if (fg2 == "")
     {
         string gw = "networks/"+g2Name+"/"+g2Name+".gw";
-        string bin = "networks/" + g2Name + "/autogenerated/" + g2Name + (args.bools["-nodes-have-types"] ? "_TypedNodes" : "_UntypedNodes") 
-        + (usingLocks ? "_Locked" : "_Unlocked") + (multi_pairwise ? "_Multi_pairwise" : "_Not_multi_pairwise") + ".bin";
-        updateG2 = newerGraphAvailable(gw.c_str(), bin.c_str());
+        string bin = Graph::binaryCacheFileName(g2Name, args.bools["-nodes-have-types"], usingLocks);
+        updateG2 = newerGraphAvailable(gw.c_str(), bin.c_str()) or not Graph::isBinaryCacheValid(bin);
     }
     else
     {
-        string bin = "networks/" + g2Name + "/autogenerated/" + g2Name + (args.bools["-nodes-have-types"] ? "_TypedNodes" : "_UntypedNodes") 
-        + (usingLocks ? "_Locked" : "_Unlocked") + (multi_pairwise ? "_Multi_pairwise" : "_Not_multi_pairwise") + ".bin";
-        updateG2 = newerGraphAvailable(fg2.c_str(), bin.c_str());
+        string bin = Graph::binaryCacheFileName(g2Name, args.bools["-nodes-have-types"], usingLocks);
+        updateG2 = newerGraphAvailable(fg2.c_str(), bin.c_str()) or not Graph::isBinaryCacheValid(bin);
     }
 #endif
 	
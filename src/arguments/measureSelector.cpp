@@ -29,6 +29,7 @@
 #include "../measures/localMeasures/Graphlet.hpp"
 #include "../measures/localMeasures/GraphletLGraal.hpp"
 #include "../measures/localMeasures/GraphletCosine.hpp"
+#include "../utils/ContentCache.hpp"
 
 using namespace std;
 
@@ -98,7 +99,7 @@ double getAlpha(Graph& G1, Graph& G2, ArgumentParser& args) {
 double totalGenericWeight(ArgumentParser& args) {
     vector<string> optimizableDoubleMeasures = {
         "ec","s3","ics","tc","sec","wec","nodec","noded","edgec","edged", "go","importance",
-        "sequence","graphlet","graphletlgraal", "graphletcosine", "spc", "nc","mec", "ewec", "ses"
+        "sequence","graphlet","graphletlgraal", "graphletcosine", "spc", "lccsn", "nc","mec", "ewec", "ses"
     };
     double total = 0;
     for (uint i = 0; i < optimizableDoubleMeasures.size(); i++) 
@@ -177,6 +178,9 @@ void initMeasures(MeasureCombination& M, Graph& G1, Graph& G2, ArgumentParser& a
 
     //detailedReport; if false, init only basic measures and any measure necessary to run SANA
     bool detRep = args.bools["-detailedreport"];
+
+    LocalMeasure::setSimBits(args.doubles["-simBits"]);
+    ContentCache::setFolder(args.strings["-cacheDir"]);
     
     bool pareto = (args.strings["-mode"] == "pareto") ? true : false;
     if(pareto) {
@@ -218,6 +222,21 @@ void initMeasures(MeasureCombination& M, Graph& G1, Graph& G2, ArgumentParser& a
     //local measures must be initialized before wec,
     //as wec uses one of the local measures
 
+    //nodec, noded, edgec and edged share one BFS from every node of each
+    //network, as deep as the deepest of them needs
+    uint neighborhoodDepth = 0;
+    uint maxDist = args.doubles["-maxDist"];
+    if (shouldInit("nodec", G1, G2, args))
+        neighborhoodDepth = max(neighborhoodDepth, (uint) args.doubleVectors["-nodecweights"].size());
+    if (shouldInit("edgec", G1, G2, args))
+        neighborhoodDepth = max(neighborhoodDepth, (uint) args.doubleVectors["-edgecweights"].size());
+    if (maxDist > 0 and shouldInit("noded", G1, G2, args))
+        neighborhoodDepth = max(neighborhoodDepth, maxDist - 1);
+    if (shouldInit("edged", G1, G2, args))
+        neighborhoodDepth = max(neighborhoodDepth, maxDist);
+    G1.reserveNeighborhoodDepth(neighborhoodDepth);
+    G2.reserveNeighborhoodDepth(neighborhoodDepth);
+
     if (shouldInit("nodec", G1, G2, args)) {
         m = new NodeCount(&G1, &G2, args.doubleVectors["-nodecweights"]);
         double nodecWeight = getWeight("nodec", G1, G2, args);
@@ -354,6 +373,11 @@ void initMeasures(MeasureCombination& M, Graph& G1, Graph& G2, ArgumentParser& a
         double spcWeight = getWeight("spc", G1, G2, args);
         M.addMeasure(m, spcWeight);
     }
+
+    if (shouldInit("lccsn", G1, G2, args)) {
+        m = new LargestCommonConnectedSubgraph(&G1, &G2, false);
+        M.addMeasure(m, getWeight("lccsn", G1, G2, args));
+    }
     
     if (args.strings["-balance"] != ""){
         M.rebalanceWeight(args.strings["-balance"]);
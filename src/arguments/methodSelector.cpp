@@ -1,4 +1,5 @@
 #include <iostream>
+#include <thread>
 
 #include "methodSelector.hpp"
 
@@ -11,6 +12,7 @@
 #include "../methods/TabuSearch.hpp"
 #include "../methods/HillClimbing.hpp"
 #include "../methods/SANA.hpp"
+#include "../methods/ParallelTempering.hpp"
 #include "../methods/RandomAligner.hpp"
 #include "../methods/wrappers/LGraalWrapper.hpp"
 #include "../methods/wrappers/HubAlignWrapper.hpp"
@@ -150,6 +152,12 @@ Method* initSANA(Graph& G1, Graph& G2, ArgumentParser& args, MeasureCombination&
     if (args.bools["-dynamictdecay"]) {
        ((SANA*) sana)->setDynamicTDecay();
     } 
+    if (args.strings["-threads"] == "max") {
+        unsigned int maxCores = thread::hardware_concurrency();
+        ((SANA*) sana)->setNumThreads(maxCores == 0 ? 1 : maxCores);
+    } else {
+        ((SANA*) sana)->setNumThreads(stoi(args.strings["-threads"]));
+    }
     if (args.strings["-lock"] != ""){
       sana->setLockFile(args.strings["-lock"] );
     }
@@ -159,6 +167,37 @@ Method* initSANA(Graph& G1, Graph& G2, ArgumentParser& args, MeasureCombination&
     return sana;
 }
 
+Method* initParallelTempering(Graph& G1, Graph& G2, ArgumentParser& args, MeasureCombination& M, string startAligName) {
+    uint numReplicas;
+    if (args.strings["-replicas"] == "max") {
+        unsigned int maxCores = thread::hardware_concurrency();
+        numReplicas = (maxCores < 2) ? 2 : maxCores;
+    } else {
+        numReplicas = stoi(args.strings["-replicas"]);
+    }
+    long long int exchangeIterations = args.doubles["-exchangeiterations"];
+    double minutes = args.doubles["-t"];
+
+    // The temperatures of the replicas are fixed, so SANA's own schedule is unused.
+    double TInitial = 0, TDecay = 0;
+#ifdef MULTI_PAIRWISE
+    SANA* sana = new SANA(&G1, &G2, TInitial, TDecay, minutes, false, false, &M, args.strings["-combinedScoreAs"], startAligName);
+#else
+    SANA* sana = new SANA(&G1, &G2, TInitial, TDecay, minutes, false, false, &M, args.strings["-combinedScoreAs"]);
+#endif
+    if (args.strings["-lock"] != ""){
+        sana->setLockFile(args.strings["-lock"]);
+    }
+    if(args.bools["-lock-same-names"] && args.strings["-lock"].size()== 0){
+        sana->setLockFile("/dev/null");
+    }
+    Method* pt = new ParallelTempering(&G1, &G2, sana, &M, minutes, numReplicas, exchangeIterations);
+    if (args.strings["-lock"] != ""){
+        pt->setLockFile(args.strings["-lock"]);
+    }
+    return pt;
+}
+
 Method* initMethod(Graph& G1, Graph& G2, ArgumentParser& args, MeasureCombination& M) {
  
     string aligFile = args.strings["-eval"];
@@ -212,6 +251,8 @@ Method* initMethod(Graph& G1, Graph& G2, ArgumentParser& args, MeasureCombinatio
 #else
         return initSANA(G1, G2, args, M);
 #endif
+    if (name == "paralleltempering" || name == "pt")
+        return initParallelTempering(G1, G2, args, M, startAligName);
     if (name == "hc")
         return new HillClimbing(&G1, &G2, &M, startAligName);
     if (name == "random")
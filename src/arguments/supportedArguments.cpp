@@ -39,7 +39,7 @@ vector<array<string, 6>> supportedArguments = {
 
     //------------------------------------METHOD-----------------------------------------
     { "", "", "banner", "", "Method", "0" },
-    { "-method", "string", "sana", "Method", "Sets the algorithm that performs the alignment. NOTE: All methods except \"sana\" call an external algorithm written by other authors. \nPossible aligners are: \"lgraal\", \"hubalign\", \"sana\", \"wave\", \"random\", \"tabu\", \"dijkstra\", \"netal\", \"mi-graal\", \"ghost\", \"piswap\", \"optnetalign\", \"spinal\", \"great\", \"natalie\", \"gedevo\", \"greedylccs\", \"magna\", \"waveSim\", \"none\", and \"hc\".", "1" },
+    { "-method", "string", "sana", "Method", "Sets the algorithm that performs the alignment. NOTE: All methods except \"sana\" call an external algorithm written by other authors. \nPossible aligners are: \"lgraal\", \"hubalign\", \"sana\", \"wave\", \"random\", \"tabu\", \"dijkstra\", \"netal\", \"mi-graal\", \"ghost\", \"piswap\", \"optnetalign\", \"spinal\", \"great\", \"natalie\", \"gedevo\", \"greedylccs\", \"magna\", \"waveSim\", \"none\", \"hc\", and \"pt\" (parallel tempering over SANA moves).", "1" },
     { "End Method", "", "banner", "", "", "0" },
     //----------------------------------END METHOD---------------------------------------
 
@@ -52,6 +52,7 @@ vector<array<string, 6>> supportedArguments = {
     { "-lock", "string", "", "Node-to-Node Locking", "Specify a two column file of node pairs that are locked in the alignment.", "0" },
     { "-lock-same-names", "bool", "false", "Node-to-Node Locking", "Locks nodes with same name together.", "0" },
     { "-seed", "double", "RANDOM", "Random Seed", "Serves as a random seed in SANA.", "0" },
+    { "-threads", "string", "1", "Independent Chains", "Number of independent SANA chains to run in parallel, each with its own seed; the best resulting alignment is kept. \"max\" uses one chain per hardware thread.", "0" },
     { "-restart", "bool", "false", "(DEPRECATED)Restart Scheme", "(DEPRECATED)Active the restart scheme in SANA.", "0" },
     { "-scheduleOnly", "bool", "false", "Temperature schedule only", "Compute temperature schedule and exit", "0" },
     { "-multi-iteration-only", "bool", "false", "Multi-Pairwise Iteration", "Skip all analysis for a normal iteration, just do the anneal", "0"},
@@ -63,6 +64,8 @@ vector<array<string, 6>> supportedArguments = {
     { "-tcand", "double", "1", "Restart Scheme t2(DEPRECATED)", "(DEPRECATED)Parameter t2 of the restart scheme, in minutes", "0" },
     { "-tfin", "double", "3", "Restart Scheme t3(DEPRECATED)", "(DEPRECATED)Parameter t3 of the restart scheme, in minutes", "0" },
     { "-use-score-based-schedule", "bool", "false", "Use score based regression", "Enable to use a pbad based linear regression", "0" },
+    { "-replicas", "string", "max", "Parallel Tempering Replicas", "Used with \"-method pt\". Number of replicas, each run by its own thread at a fixed temperature. \"max\" uses one replica per hardware thread.", "0" },
+    { "-exchangeiterations", "double", "1000000", "Parallel Tempering Exchange Interval", "Used with \"-method pt\". SANA iterations each replica does between attempts to exchange temperatures with its neighbors.", "0" },
     { "END Additional options to consider when method is \"sana\" (the default)", "", "banner", "", "", "0" },
     //----------------------------------END SANA-----------------------------------------
 
@@ -104,7 +107,8 @@ vector<array<string, 6>> supportedArguments = {
     { "-nc", "double", "0", "Weight of NC", "This weight of Node Correctness in the objective function. To be used when \"-objfuntype\" is \"generic\".", "1" },
     { "-tc", "double", "0", "Weight of TC", "The weight of Triangle Correctness in the objetive function. To be used when \"-objfuntype\" is \"generic\".", "1" },
     { "-wec", "double", "0", "Weight of WEC.", "Weight of the weighted edge coverage. To be used when \"-objfuntype\" is \"generic\". If non-zero, must specify how to weigh the edge using -wecnodesim.", "1" },
-    { "-spc", "double", "0", "Shortest Path Conservation", "Objective function to minimize shortest path difference between pairs of nodes in G1 and G2. Used when \"-objfuntype\" is \"generic\".", "1" },
+    { "-spc", "double", "0", "Shortest Path Conservation", "Weight of SPC, 1 minus the average difference between the distance of two G1 nodes and the distance of their images, over the largest distance (pairs connected in only one network count as the largest distance). SANA optimizes it incrementally with the sum objective score. Used when \"-objfuntype\" is \"generic\".", "1" },
+    { "-lccsn", "double", "0", "Largest Common Connected Subgraph (nodes)", "Weight of LCCSN, the fraction of the G1 nodes in the largest connected component of the common subgraph (unlike lccs, which also counts the induced edges as in MAGNA). SANA optimizes it incrementally with the sum objective score. Used when \"-objfuntype\" is \"generic\".", "1" },
     { "-importance", "double", "0", "Weight of Importance", "HubAlign's objective function. Used when \"-objfuntype\" is \"generic\".", "1" },
     { "-nodec", "double", "0", "Weight of Node Count", "The weight of the Local Node Count objective function. Used when \"-objfuntype\" is \"generic\".", "1" },
     { "-noded", "double", "0", "Weight of Node Density", "The weight of the Local Node Density objective function. Used when \"-objfuntype\" is \"generic\".", "1" },
@@ -134,6 +138,8 @@ vector<array<string, 6>> supportedArguments = {
     { "-maxGraphletSize", "double", "", "Maximum Graphlet Size", "Chooses the maximum size of graphlets to use. Saves human_gdv and yeast_gdv files ending with the given maximum graphlet size in order to distinguish between different-sized graphlets (e.g. human_gdv4.txt and yeast_gdv4.txt, for maximum graphlet size of 4).", "0" },
     { "-simFile", "str_vec", "0", "Similarity File", "Specify an external three columnn (node from G1, node from  G2, similarity) file. These will be given weight according to the -esim argument.", "1" },
         { "-ewecFile", "string", "", "egdvs file", "egdvs output file produced by GREAT", "1"},
+    { "-simBits", "double", "32", "Bits per Similarity", "Bits per entry of the similarity matrices of the local measures: 32 (floats), 16 or 8. With 16 or 8 the matrices are stored as fixed point numbers with a per-matrix scale, which takes half or a quarter of the memory; each similarity is then off by at most half a step of 1/65535 or 1/255 of the range of its matrix.", "0" },
+    { "-cacheDir", "string", "", "Content Cache Folder", "Folder where the topological similarity matrices and the graphlet degree vectors are kept once computed, named after a hash of the networks' contents and of the parameters, and reused by later runs on the same networks under any name. Several runs can share the folder at once. Off by default.", "0" },
         { "-detailedreport", "bool", "false", "Detailed Report", "If false, initialize only basic measures and any measure necessary to run SANA.", "1" },
     { "End Further Weight Specification. Combine with \"-method x -objfuntype y\"", "", "banner", "", "", "0" },
     //--------------END Further details of \"-method x -objfuntype y\"-------------------
@@ -193,7 +199,8 @@ vector<array<string, 6>> supportedArguments = {
 
     //---------------------------------SIMILARITY----------------------------------------
     { "", "", "banner", "", "More options for \"-mode similarity\"", "0" },
-    { "-simFormat", "dbl_vec", "0", "Similarity File Format", "Used in Similarity Mode \"-mode similarity\" and with \"-objfuntype -esim\". Allowed values are 2=G1 doubles down by G2 doubles across matrix where node order corresponds to .gw files; 1=node names; 0=node integers numbered as in LEDA .gw format.", "0" },
+    { "-simFormat", "dbl_vec", "0", "Similarity File Format", "Used in Similarity Mode \"-mode similarity\" and with \"-objfuntype -esim\". Allowed values are 3=binary, written by \"-mode similarity\" and much faster to load; 2=G1 doubles down by G2 doubles across matrix where node order corresponds to .gw files; 1=node names; 0=node integers numbered as in LEDA .gw format.", "0" },
+    { "-simTopK", "double", "0", "Similarities Per Node", "Used in Similarity Mode \"-mode similarity\" with formats 0, 1 and 3. If k > 0, only the k largest similarities of each G1 node are written, most similar first, instead of all of them; the others read as 0 with -simFile. 0 writes every similarity.", "0" },
     { "End More options for \"-mode similarity\"", "", "banner", "", "", "0" },
     //-------------------------------END SIMILARITY--------------------------------------
 
@@ -212,7 +212,7 @@ void printProteinPairCountInNetworks(bool BioGRIDNetworks) {
     cout << endl;
 }
 
-void fillTableColumn(vector<vector<string> >& table, uint col, vector<vector<float> >* simMatrix,
+void fillTableColumn(vector<vector<string> >& table, uint col, const SimMatrix* simMatrix,
     const vector<vector<uint> >& complementProteins, const vector<vector<uint> >& nonComplementProteins,
     const vector<vector<uint> >& randomProteins) {
     uint nComp = complementProteins.size();
@@ -275,36 +275,36 @@ void printLocalTopologicalSimilarities(Graph& G1, Graph& G2, bool BioGRIDNetwork
 
     table[0][2] = "graphlet";
     Graphlet graphletSim(&G1, &G2);
-    vector<vector<float> >* graphletSimMatrix = graphletSim.getSimMatrix();
+    const SimMatrix* graphletSimMatrix = graphletSim.getSimMatrix();
     fillTableColumn(table, 2, graphletSimMatrix,
         complementProteins, nonComplementProteins, randomProteins);
     table[0][3] = "node density";
     NodeCount NodeCountSim(&G1, &G2, {0,0,1});
-    vector<vector<float> >* NodeCountSimMatrix = NodeCountSim.getSimMatrix();
+    const SimMatrix* NodeCountSimMatrix = NodeCountSim.getSimMatrix();
     fillTableColumn(table, 3, NodeCountSimMatrix,
         complementProteins, nonComplementProteins, randomProteins);
 
     table[0][4] = "edge density";
     EdgeCount EdgeCountSim(&G1, &G2, {0,0,1});
-    vector<vector<float> >* EdgeCountSimMatrix = EdgeCountSim.getSimMatrix();
+    const SimMatrix* EdgeCountSimMatrix = EdgeCountSim.getSimMatrix();
     fillTableColumn(table, 4, EdgeCountSimMatrix,
         complementProteins, nonComplementProteins, randomProteins);
 
     table[0][5] = "importance";
     Importance importance(&G1, &G2);
-    vector<vector<float> >* importanceMatrix = importance.getSimMatrix();
+    const SimMatrix* importanceMatrix = importance.getSimMatrix();
     fillTableColumn(table, 5, importanceMatrix,
         complementProteins, nonComplementProteins, randomProteins);
 
     table[0][6] = "sequence";
     Sequence sequence(&G1, &G2);
-    vector<vector<float> >* sequenceMatrix = sequence.getSimMatrix();
+    const SimMatrix* sequenceMatrix = sequence.getSimMatrix();
     fillTableColumn(table, 6, sequenceMatrix,
         complementProteins, nonComplementProteins, randomProteins);
 
     table[0][7] = "go counts";
     GoSimilarity goSim(&G1, &G2, {1}, 1);
-    vector<vector<float> >* goSimMatrix = goSim.getSimMatrix();
+    const SimMatrix* goSimMatrix = goSim.getSimMatrix();
     fillTableColumn(table, 7, goSimMatrix,
         complementProteins, nonComplementProteins, randomProteins);
 
@@ -13,6 +13,14 @@
 #include <algorithm>
 #include <vector>
 
+//ORCA orbit counts (graphlet degree vectors) of every node of the graph with n
+//nodes and the given edges, for graphlets of up to maxGraphletSize (4 or 5)
+//nodes. The counting is split across numThreads threads (0 means one per core).
+//There is no global state, so several graphs can be counted at the same time.
+std::vector<std::vector<uint> > computeGraphlets(int maxGraphletSize, uint n,
+    const std::vector<std::vector<uint> >& edgeList, uint numThreads = 0);
+
+//same, for a file with "n m" followed by m lines "node1 node2"
 std::vector<std::vector<uint> > computeGraphlets(int maxGraphletSize, std::string graphFileName);
 
 #endif
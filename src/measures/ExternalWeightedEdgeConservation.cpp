@@ -1,31 +1,25 @@
 #include "ExternalWeightedEdgeConservation.hpp"
-#include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <limits>
+#include <cstdlib>
+
+static const uint NONE = std::numeric_limits<uint>::max();
 
 ExternalWeightedEdgeConservation::ExternalWeightedEdgeConservation(Graph* G1, Graph* G2, std::string scoresFile) : Measure(G1, G2, "ewec"){
-    G1->getAdjLists(adjListG1);
-    G2->getAdjLists(adjListG2);
-    G1->getMatrix(matrixG1);
-    G2->getMatrix(matrixG2);
-    nodeNamesG1 = G1->getNodeNames();
-    nodeNamesG2 = G2->getNodeNames();
+    rowIndex.build(*G1);
+    colIndex.build(*G2);
     loadMatrix(scoresFile);
 }
 
 double ExternalWeightedEdgeConservation::eval(const Alignment& A){
-    std::vector<std::vector<uint> > edgeListG1;
-    G1->getEdgeList(edgeListG1);
-    //std::vector<std::vector<bool> > adjMatrixG2;
-    //G2->getAdjMatrix(adjMatrixG2);
+    const Matrix<MATRIX_UNIT>& matrixG2 = G2->getMatrix();
     double score = 0;
-    for (const auto& edge: edgeListG1) {
+    for (const auto& edge: G1->getEdgeList()) {
         uint node1 = edge[0], node2 = edge[1];
-        if (matrixG2[A[node1]][A[node2]]) {
-            std::string n1s = nodeNamesG1[node1], n2s = nodeNamesG1[node2];
-            std::string an1s = nodeNamesG2[A[node1]], an2s = nodeNamesG2[A[node2]];
-            int e1 = getRowIndex(n1s, n2s); //Row for G1 and Col for G2
-            int e2 = getColIndex(an1s, an2s);
+        if (matrixG2.get(A[node1], A[node2])) {
+            uint e1 = rowIndex.find(node1, node2); //Row for G1 and Col for G2
+            uint e2 = colIndex.find(A[node1], A[node2]);
             score += getScore(e2, e1);
         }
     }
@@ -34,201 +28,139 @@ double ExternalWeightedEdgeConservation::eval(const Alignment& A){
     return score;
 }
 
-void ExternalWeightedEdgeConservation::breakEdge(std::string e, std::string &n1, std::string &n2){
-    int breakPoint = e.find('-');
-    e[breakPoint] = ' ';
-    std::stringstream ss(e);
-    ss >> n1;
-    ss >> n2;
-}
-
-void ExternalWeightedEdgeConservation::addEdgeToCol(std::string e, int ind){
-    std::string n1;
-    std::string n2;
-    breakEdge(e, n1, n2);
-    int n1Index = std::distance(nodeNamesG2.begin(), std::find(nodeNamesG2.begin(), nodeNamesG2.end(), n1));
-    int n2Index = std::distance(nodeNamesG2.begin(), std::find(nodeNamesG2.begin(), nodeNamesG2.end(), n2));
-    if(n1Index > n2Index){
-        int n3Index = n1Index;
-        n1Index = n2Index;
-        n2Index = n3Index;
+double ExternalWeightedEdgeConservation::simCombo(const std::vector<uint>& A, uint source, uint target) const {
+    const Matrix<MATRIX_UNIT>& matrixG2 = G2->getMatrix();
+    double score = 0;
+    for (uint k = rowIndex.offsets[source]; k < rowIndex.offsets[source+1]; k++) {
+        uint neighborTarget = A[rowIndex.neighbors[k]];
+        if (matrixG2.get(target, neighborTarget)) {
+            score += getScore(colIndex.find(target, neighborTarget), rowIndex.ids[k]);
+        }
     }
-    colIndex[n1Index][n2Index] = ind;
+    return score;
 }
 
-void ExternalWeightedEdgeConservation::addEdgeToRow(std::string e, int ind){
-    std::string n1;
-    std::string n2;
-    breakEdge(e, n1, n2);
-    int n1Index = std::distance(nodeNamesG1.begin(), std::find(nodeNamesG1.begin(), nodeNamesG1.end(), n1));
-    int n2Index = std::distance(nodeNamesG1.begin(), std::find(nodeNamesG1.begin(), nodeNamesG1.end(), n2));
-    if(n1Index > n2Index){
-        int n3Index = n1Index;
-        n1Index = n2Index;
-        n2Index = n3Index;
-    }
-    rowIndex[n1Index][n2Index] = ind;
+uint ExternalWeightedEdgeConservation::getRowIndex(uint n1, uint n2) const {
+    return rowIndex.find(n1, n2);
 }
 
-void ExternalWeightedEdgeConservation::loadMatrix(std::string scoresFile){
-    simScores = std::vector<std::vector<double>>();
-    colIndex = std::vector<std::vector<int>>(nodeNamesG2.size(), vector<int>(nodeNamesG2.size()));
-    rowIndex = std::vector<std::vector<int>>(nodeNamesG1.size(), vector<int>(nodeNamesG1.size()));
-
-    std::ifstream infile(scoresFile);
-    if( !infile  ) {
-        std::cout << "Can't open file " << scoresFile << std::endl;
-        std::exit( -1 );
-    }
-    std::string line;
-    int r = 0;
-    int c = 0;
+uint ExternalWeightedEdgeConservation::getColIndex(uint n1, uint n2) const {
+    return colIndex.find(n1, n2);
+}
 
-    //process first row from file
-    std::getline(infile, line);
-    std::stringstream colHeadersStream(line);
-    std::string edge1;
-    while(colHeadersStream >> edge1){
-        addEdgeToCol(edge1, c);
-        simScores.push_back(vector<double>());
-        ++c;
-    }
-    
-    //process rest of the file
-    while(std::getline(infile, line)){
-        c = 0;
-        std::stringstream lnStream(line);
-        std::string edge2;
-        lnStream >> edge2;
-        addEdgeToRow(edge2, r);
-        
-        double value;
-        while(lnStream >> value){
-            simScores[c].push_back(value);
-            ++c;
-        }
-        ++r;
+void ExternalWeightedEdgeConservation::EdgeIndex::build(const Graph& G) {
+    const std::vector<std::vector<uint> >& adjLists = G.getAdjLists();
+    uint n = G.getNumNodes();
+    offsets.assign(n+1, 0);
+    for (uint i = 0; i < n; i++) offsets[i+1] = offsets[i] + adjLists[i].size();
+    neighbors.resize(offsets[n]);
+    for (uint i = 0; i < n; i++) {
+        std::copy(adjLists[i].begin(), adjLists[i].end(), neighbors.begin() + offsets[i]);
+        std::sort(neighbors.begin() + offsets[i], neighbors.begin() + offsets[i+1]);
     }
+    ids.assign(offsets[n], NONE);
+    missingId = NONE;
 }
 
-double ExternalWeightedEdgeConservation::getScore(int colNum, int rowNum){
-    return simScores[colNum][rowNum];
+size_t ExternalWeightedEdgeConservation::EdgeIndex::position(uint u, uint v) const {
+    auto begin = neighbors.begin() + offsets[u], end = neighbors.begin() + offsets[u+1];
+    auto it = std::lower_bound(begin, end, v);
+    if (it == end or *it != v) return ids.size();
+    return it - neighbors.begin();
 }
 
-int ExternalWeightedEdgeConservation::getColIndex(std::string n1, std::string n2){
-    int n1Index = std::distance(nodeNamesG2.begin(), std::find(nodeNamesG2.begin(), nodeNamesG2.end(), n1));
-    int n2Index = std::distance(nodeNamesG2.begin(), std::find(nodeNamesG2.begin(), nodeNamesG2.end(), n2));
-    return getColIndex(n1Index, n2Index);
+uint ExternalWeightedEdgeConservation::EdgeIndex::find(uint u, uint v) const {
+    size_t k = position(u, v);
+    return k == ids.size() ? missingId : ids[k];
 }
 
-int ExternalWeightedEdgeConservation::getRowIndex(std::string n1, std::string n2){
-    int n1Index = std::distance(nodeNamesG1.begin(), std::find(nodeNamesG1.begin(), nodeNamesG1.end(), n1));
-    int n2Index = std::distance(nodeNamesG1.begin(), std::find(nodeNamesG1.begin(), nodeNamesG1.end(), n2));
-    return getRowIndex(n1Index, n2Index);
+void ExternalWeightedEdgeConservation::EdgeIndex::setId(uint u, uint v, uint id) {
+    ids[position(u, v)] = id;
+    ids[position(v, u)] = id;
 }
 
-int ExternalWeightedEdgeConservation::getColIndex(uint n1, uint n2){
-    bool orderCorrect = n1 < n2;
-    if(!orderCorrect){
-        uint n3 = n1;
-        n1 = n2;
-        n2 = n3;
-    }
-    return colIndex[n1][n2];
+bool ExternalWeightedEdgeConservation::parseEdge(const std::string& e,
+        const std::unordered_map<std::string, uint>& nameToIndex, const Graph& G, uint& n1, uint& n2) {
+    size_t breakPoint = e.find('-');
+    if (breakPoint == std::string::npos) return false;
+    auto it1 = nameToIndex.find(e.substr(0, breakPoint));
+    auto it2 = nameToIndex.find(e.substr(breakPoint+1));
+    if (it1 == nameToIndex.end() or it2 == nameToIndex.end()) return false;
+    n1 = it1->second;
+    n2 = it2->second;
+    return G.getMatrix().get(n1, n2);
 }
 
-int ExternalWeightedEdgeConservation::getRowIndex(uint n1, uint n2){
-    bool orderCorrect = n1 < n2;
-    if(!orderCorrect){
-        uint n3 = n1;
-        n1 = n2;
-        n2 = n3;
-    }
-    return rowIndex[n1][n2];
-}
-/* Deprecated, do not use.
-double ExternalWeightedEdgeConservation::simScore(uint source, uint target, const Alignment& A){
-    double score = 0;
-    for (uint i = 0; i < adjListG1[source].size(); ++i) {
-        uint neighbor = adjListG1[source][i];
-        if (adjMatrixG2[target][A[neighbor]]) {
-            int e1 = getRowIndex(source, neighbor);
-            int e2 = getColIndex(target, A[neighbor]);
-            score+=getScore(e2,e1);
-        }   
-    }
-    score /= (2*G1->getNumEdges()); //normalization
-    return score;
+static std::unordered_map<std::string, uint> nameToIndexMap(const Graph& G) {
+    std::vector<std::string> names = G.getNodeNames();
+    std::unordered_map<std::string, uint> res;
+    res.reserve(names.size());
+    for (uint i = 0; i < names.size(); i++) res[names[i]] = i;
+    return res;
 }
 
-double ExternalWeightedEdgeConservation::changeOp(uint source, uint oldTarget, uint newTarget, const Alignment& A){
-    uint neighbor;
-    int e1, e2;
-    double score = 0;
-    int size1 = adjListG1[source].size();
-    for(int i = 0; i < size1; ++i){
-        neighbor = adjListG1[source][i];
-        if(adjMatrixG2[oldTarget][A[neighbor]]){
-            std::string n1s = nodeNamesG1[source], n2s = nodeNamesG1[neighbor];
-            std::string an1s = nodeNamesG2[oldTarget], an2s = nodeNamesG2[A[neighbor]];
-            e1 = getRowIndex(n1s, n2s);
-            e2 = getColIndex(an1s, an2s);
-            score -= getScore(e2,e1);
-        }
-        if(adjMatrixG2[newTarget][A[neighbor]]){
-            std::string n1s = nodeNamesG1[source], n2s = nodeNamesG1[neighbor];
-            std::string an1s = nodeNamesG2[newTarget], an2s = nodeNamesG2[A[neighbor]];
-            e1 = getRowIndex(n1s, n2s);
-            e2 = getColIndex(an1s, an2s);
-            score += getScore(e2, e1);
-        }
+void ExternalWeightedEdgeConservation::loadMatrix(std::string scoresFile){
+    std::ifstream infile(scoresFile);
+    if( !infile  ) {
+        throw runtime_error("Can't open file " + scoresFile);
     }
-    score /= (2*G1->getNumEdges());
-    return score;
-}
+    std::unordered_map<std::string, uint> namesG1 = nameToIndexMap(*G1), namesG2 = nameToIndexMap(*G2);
+    std::string line, edge;
+    uint n1, n2;
 
-double ExternalWeightedEdgeConservation::swapOp(uint source1, uint source2, uint target1, uint target2, const Alignment& A){
-    uint neighbor;
-    int e1, e2;
-    double score = 0;
-    int size1 = adjListG1[source1].size();
-    int size2 = adjListG1[source2].size();
-    for(int i = 0; i < size1; ++i){
-        neighbor = adjListG1[source1][i];
-        if(adjMatrixG2[target1][A[neighbor]]){
-            std::string n1s = nodeNamesG1[source1], n2s = nodeNamesG1[neighbor];
-            std::string an1s = nodeNamesG2[target1], an2s = nodeNamesG2[A[neighbor]];
-            e1 = getRowIndex(n1s, n2s);
-            e2 = getColIndex(an1s, an2s);
-            score -= getScore(e2,e1);
+    //first row: the column of each G2 edge, NONE for the columns that are dropped
+    std::getline(infile, line);
+    std::vector<uint> fileColumns;
+    numCols = 0;
+    size_t begin = line.find_first_not_of(" \t\r");
+    while (begin != std::string::npos) {
+        size_t end = line.find_first_of(" \t\r", begin);
+        edge = line.substr(begin, end == std::string::npos ? std::string::npos : end-begin);
+        begin = line.find_first_not_of(" \t\r", end);
+        if (not parseEdge(edge, namesG2, *G2, n1, n2)) {
+            fileColumns.push_back(NONE);
+            continue;
         }
-        if(adjMatrixG2[target2][A[neighbor]]){
-            std::string n1s = nodeNamesG1[source1], n2s = nodeNamesG1[neighbor];
-            std::string an1s = nodeNamesG2[target2], an2s = nodeNamesG2[A[neighbor]];
-            e1 = getRowIndex(n1s, n2s);
-            e2 = getColIndex(an1s, an2s);
-            score += getScore(e2, e1);
+        uint col = colIndex.find(n1, n2);
+        if (col == NONE) {
+            col = numCols++;
+            colIndex.setId(n1, n2, col);
         }
+        fileColumns.push_back(col);
     }
+    rowLength = numCols + 1;
 
-    for(int i = 0; i < size2; ++i){
-        uint neighbor = adjListG1[source2][i];
-        if(adjMatrixG2[target2][A[neighbor]]){
-            std::string n1s = nodeNamesG1[source2], n2s = nodeNamesG1[neighbor];
-            std::string an1s = nodeNamesG2[target2], an2s = nodeNamesG2[A[neighbor]];
-            e1 = getRowIndex(n1s, n2s);
-            e2 = getColIndex(an1s, an2s);
-            score -= getScore(e2, e1);
+    //rest of the file, a row at a time
+    numRows = 0;
+    scores.clear();
+    while(std::getline(infile, line)){
+        const char* p = line.c_str();
+        while (*p == ' ' or *p == '\t') p++;
+        const char* edgeEnd = p;
+        while (*edgeEnd and *edgeEnd != ' ' and *edgeEnd != '\t' and *edgeEnd != '\r') edgeEnd++;
+        edge.assign(p, edgeEnd);
+        if (edge.empty() or not parseEdge(edge, namesG1, *G1, n1, n2)) continue;
+        uint row = rowIndex.find(n1, n2);
+        if (row == NONE) {
+            row = numRows++;
+            rowIndex.setId(n1, n2, row);
+            scores.resize(scores.size() + rowLength, 0);
         }
-        if(adjMatrixG2[target1][A[neighbor]]){
-            std::string n1s = nodeNamesG1[source2], n2s = nodeNamesG1[neighbor];
-            std::string an1s = nodeNamesG2[target1], an2s = nodeNamesG2[A[neighbor]];
-            e1 = getRowIndex(n1s, n2s);
-            e2 = getColIndex(an1s, an2s);
-            score += getScore(e2, e1);
+        double* rowScores = &scores[(size_t) row * rowLength];
+        p = edgeEnd;
+        for (uint c = 0; c < fileColumns.size(); c++) {
+            char* valueEnd;
+            double value = strtod(p, &valueEnd);
+            if (valueEnd == p) break;
+            p = valueEnd;
+            if (fileColumns[c] != NONE) rowScores[fileColumns[c]] = value;
         }
     }
 
-    score /= (2*G1->getNumEdges());
-    return score;
-}*/ 
+    //the edges that are not in the file score 0
+    scores.resize(scores.size() + rowLength, 0);
+    rowIndex.missingId = numRows;
+    colIndex.missingId = numCols;
+    std::replace(rowIndex.ids.begin(), rowIndex.ids.end(), NONE, numRows);
+    std::replace(colIndex.ids.begin(), colIndex.ids.end(), NONE, numCols);
+}
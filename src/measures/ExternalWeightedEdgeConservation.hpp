@@ -2,48 +2,54 @@
 #define EXTERNALWEIGHTEDEDGECONSERVATION_HPP
 #include <vector>
 #include <iostream>
-#include <map>
 #include <string>
+#include <unordered_map>
 #include "Measure.hpp"
 #include "localMeasures/LocalMeasure.hpp"
 #include "../Graph.hpp"
 
-//assuming input file is egdvs file generated from GREAT
+//assuming input file is egdvs file generated from GREAT: a first line with
+//the G2 edges ("a-b") and then a line per G1 edge with the edge and its score
+//with each G2 edge. Only the edges of the graphs are kept, indexed through
+//their adjacency lists, so memory is O(n + scores) instead of O(n^2).
+//Edges missing from the file score 0.
 
 class ExternalWeightedEdgeConservation: public Measure {
 public:
     ExternalWeightedEdgeConservation(Graph* G1, Graph* G2, std::string scoresFile);
-    //virtual ~ExternalWeightedEdgeConservation();
     double eval(const Alignment& A);
-    //double simScore(uint source, uint target, const Alignment& A);
-    //double changeOp(uint source, uint oldTarget, uint newTarget, const Alignment& A);
-    //double swapOp(uint source1, uint source2, uint target1, uint target2, const Alignment& A);
-    int getColIndex(uint n1, uint n2); //make these private before you push 
-    int getRowIndex(uint n1, uint n2);
-    double getScore(int colNum, int rowNum); //returns sim score given the indices of the col and row
 
-private:
-    std::vector<std::vector<double>> simScores;
-    std::vector<std::vector<int>> colIndex;
-    std::vector<std::vector<int>> rowIndex;
-    std::vector<std::vector<uint> > adjListG1;
-    std::vector<std::vector<uint> > adjListG2;
-    Matrix<MATRIX_UNIT> matrixG1;
-    Matrix<MATRIX_UNIT> matrixG2;
-    std::vector<std::string> nodeNamesG1;
-    std::vector<std::string> nodeNamesG2;
-
-    void breakEdge(std::string e, std::string &n1, std::string &n2); //breaks edge e into nodes and assign them to n1 and n2
-
-    void addEdgeToCol(std::string e, int ind);
-    void addEdgeToRow(std::string e, int ind);
+    //row of the G1 edge and column of the G2 edge in the score table
+    uint getRowIndex(uint n1, uint n2) const;
+    uint getColIndex(uint n1, uint n2) const;
+    double getScore(uint colNum, uint rowNum) const { //returns sim score given the indices of the col and row
+        return scores[(size_t) rowNum * rowLength + colNum];
+    }
+    //sum of the scores of the edges of source that are conserved if it is
+    //mapped to target and its neighbors as in A
+    double simCombo(const std::vector<uint>& A, uint source, uint target) const;
 
-    //initialize member variables in loadMatrix
-    void loadMatrix(std::string scoresFile); //loads simScores from input file while indexing edges
-    int getColIndex(std::string n1, std::string n2); 
-    int getRowIndex(std::string n1, std::string n2);
+private:
+    //edge ids in the order of sorted adjacency lists, so that the id of
+    //(u, v) is found by a binary search in the neighbors of u
+    struct EdgeIndex {
+        std::vector<uint> offsets, neighbors, ids;
+        uint missingId; //id of the edges that are not in the file
+        void build(const Graph& G);
+        size_t position(uint u, uint v) const; //ids.size() if (u, v) is not an edge
+        uint find(uint u, uint v) const;
+        void setId(uint u, uint v, uint id);
+    };
+    EdgeIndex rowIndex, colIndex;
+    uint numRows, numCols; //edges of the file that were kept; row numRows and column numCols are 0s
+    size_t rowLength;      //numCols + 1
+    std::vector<double> scores;
+
+    //streams the file, keeping only the rows and columns of edges of G1 and G2
+    void loadMatrix(std::string scoresFile);
+    //node indices of the edge "n1-n2", false if a node is unknown or they are not adjacent
+    static bool parseEdge(const std::string& e, const std::unordered_map<std::string, uint>& nameToIndex,
+        const Graph& G, uint& n1, uint& n2);
 };
 
 #endif
-
-
@@ -7,6 +7,7 @@ public:
     GoAverage(Graph* G1, Graph* G2);
     virtual ~GoAverage();
     double eval(const Alignment& A);
+    bool isThreadSafe() { return false; }
 private:
 
 };
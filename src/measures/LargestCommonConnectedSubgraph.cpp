@@ -1,36 +1,371 @@
 #include <vector>
 #include <cmath>
+#include <limits>
 #include "LargestCommonConnectedSubgraph.hpp"
 
-LargestCommonConnectedSubgraph::LargestCommonConnectedSubgraph(Graph* G1, Graph* G2) : Measure(G1, G2, "lccs") {
+static const uint NONE = numeric_limits<uint>::max();
+
+LargestCommonConnectedSubgraph::LargestCommonConnectedSubgraph(Graph* G1, Graph* G2, bool magnaDefinition) :
+    Measure(G1, G2, magnaDefinition ? "lccs" : "lccsn"), magnaDefinition(magnaDefinition) {
 }
 
 LargestCommonConnectedSubgraph::~LargestCommonConnectedSubgraph() {
 }
 
 double LargestCommonConnectedSubgraph::eval(const Alignment& A) {
-    Graph CS = A.commonSubgraph(*G1, *G2);
-    vector<uint> LCCSNodes = CS.getConnectedComponents()[0]; //largest CC
+    vector<vector<uint> > components;
+    vector<uint> componentEdges;
+    A.commonConnectedComponents(*G1, *G2, components, componentEdges);
+    const vector<uint>& LCCSNodes = components[0]; //largest CC
     uint n = LCCSNodes.size();
     double N = (double) n/G1->getNumNodes();
-    if (not USE_MAGNA_DEFINITION) return N;
+    if (not magnaDefinition) return N;
 
     // To Get the indexes of the common subgraph in G2
     vector<uint> LCCSNodesG2;
     for(uint node: LCCSNodes)
         LCCSNodesG2.push_back(A[node]);
 
-    Graph G1InducedSubgraph = G1->nodeInducedSubgraph(LCCSNodes);
-    Graph G2InducedSubgraph = G2->nodeInducedSubgraph(LCCSNodesG2);
-    double E1 = (double) G1InducedSubgraph.getNumEdges()/G1->getNumEdges();
-    double E2 = (double) G2InducedSubgraph.getNumEdges()/G2->getNumEdges();
+    double E1 = (double) G1->numNodeInducedSubgraphEdges(LCCSNodes)/G1->getNumEdges();
+    double E2 = (double) G2->numNodeInducedSubgraphEdges(LCCSNodesG2)/G2->getNumEdges();
     double E = min(E1,E2);
     return sqrt(E*N);
 }
 
 double LargestCommonConnectedSubgraph::nodeProportion(const Alignment& A) {
-    Graph CS = A.commonSubgraph(*G1, *G2);
-    vector<uint> LCCSNodes = CS.getConnectedComponents()[0]; //largest CC
-    uint n = LCCSNodes.size();
+    vector<vector<uint> > components;
+    vector<uint> componentEdges;
+    A.commonConnectedComponents(*G1, *G2, components, componentEdges);
+    uint n = components[0].size(); //largest CC
     return (double) n/G1->getNumNodes();
 }
+
+void LargestCommonConnectedSubgraph::initIncremental(const vector<uint>& A) {
+    uint n = G1->getNumNodes();
+    const vector<vector<uint> >& adjLists = G1->getAdjLists();
+    const Matrix<MATRIX_UNIT>& G2Matrix = G2->getMatrix();
+    comp.assign(n, NONE);
+    pos.assign(n, 0);
+    members.assign(n, vector<uint>(0));
+    compSizes.clear();
+    uint numComps = 0;
+    for (uint i = 0; i < n; i++) {
+        if (comp[i] != NONE) continue;
+        uint c = numComps++;
+        attach(i, c);
+        //members[c] is the BFS queue
+        for (uint k = 0; k < members[c].size(); k++) {
+            uint x = members[c][k];
+            for (uint y : adjLists[x]) {
+                if (comp[y] == NONE and G2Matrix.get(A[x], A[y])) attach(y, c);
+            }
+        }
+        compSizes.insert(members[c].size());
+    }
+    freeComps.clear();
+    for (uint c = n; c > numComps; c--) freeComps.push_back(c-1);
+
+    stamp = 0;
+    visitStamp.assign(n, 0);
+    visitSearch.assign(n, NONE);
+    compStamp.assign(n, 0);
+    compPiece.assign(n, NONE);
+    numSearches = 0;
+    numMoved = 0;
+}
+
+uint LargestCommonConnectedSubgraph::largestSize() const {
+    return *compSizes.rbegin();
+}
+
+uint LargestCommonConnectedSubgraph::changeOpLargest(const vector<uint>& A, uint source, uint newTarget) {
+    numMoved = 1;
+    movedNodes[0] = source;
+    movedTargets[0] = newTarget;
+    return proposeMove(A);
+}
+
+uint LargestCommonConnectedSubgraph::swapOpLargest(const vector<uint>& A, uint source1, uint source2) {
+    if (source1 == source2) return changeOpLargest(A, source1, A[source1]);
+    numMoved = 2;
+    movedNodes[0] = source1;
+    movedNodes[1] = source2;
+    movedTargets[0] = A[source2];
+    movedTargets[1] = A[source1];
+    return proposeMove(A);
+}
+
+bool LargestCommonConnectedSubgraph::isMoved(uint node) const {
+    return node == movedNodes[0] or (numMoved == 2 and node == movedNodes[1]);
+}
+
+uint LargestCommonConnectedSubgraph::newTarget(const vector<uint>& A, uint node) const {
+    if (node == movedNodes[0]) return movedTargets[0];
+    if (numMoved == 2 and node == movedNodes[1]) return movedTargets[1];
+    return A[node];
+}
+
+void LargestCommonConnectedSubgraph::nextStamp() {
+    stamp++;
+    if (stamp == 0) {
+        fill(visitStamp.begin(), visitStamp.end(), 0);
+        fill(compStamp.begin(), compStamp.end(), 0);
+        stamp = 1;
+    }
+}
+
+void LargestCommonConnectedSubgraph::startSearch(uint node, uint affected) {
+    uint s = numSearches++;
+    if (searches.size() < numSearches) {
+        searches.resize(numSearches);
+        searchParent.resize(numSearches);
+        liveSearches.resize(numSearches);
+        searchPiece.resize(numSearches);
+    }
+    searches[s].affected = affected;
+    searches[s].head = 0;
+    searches[s].nodes.clear();
+    searches[s].nodes.push_back(node);
+    visitStamp[node] = stamp;
+    visitSearch[node] = s;
+    searchParent[s] = s;
+    liveSearches[s] = 1;
+    liveGroups[affected]++;
+}
+
+uint LargestCommonConnectedSubgraph::findSearch(uint s) {
+    while (searchParent[s] != s) {
+        searchParent[s] = searchParent[searchParent[s]];
+        s = searchParent[s];
+    }
+    return s;
+}
+
+//expands one node of each search in turn, without crossing the edges of the
+//moved nodes, until every affected component has at most one group of
+//searches that is not exhausted
+void LargestCommonConnectedSubgraph::runSearches(const vector<uint>& A) {
+    const vector<vector<uint> >& adjLists = G1->getAdjLists();
+    const Matrix<MATRIX_UNIT>& G2Matrix = G2->getMatrix();
+    while (liveGroups[0] >= 2 or liveGroups[1] >= 2) {
+        for (uint s = 0; s < numSearches; s++) {
+            Search& search = searches[s];
+            uint a = search.affected;
+            if (liveGroups[a] < 2 or search.head == search.nodes.size()) continue;
+            uint x = search.nodes[search.head++];
+            for (uint y : adjLists[x]) {
+                if (not G2Matrix.get(A[x], A[y])) continue;
+                if (visitStamp[y] != stamp) {
+                    visitStamp[y] = stamp;
+                    visitSearch[y] = s;
+                    search.nodes.push_back(y);
+                    continue;
+                }
+                uint t = visitSearch[y];
+                if (t == NONE) continue; //moved
+                uint rs = findSearch(s), rt = findSearch(t);
+                if (rs == rt) continue;
+                liveGroups[a] -= (liveSearches[rs] > 0) + (liveSearches[rt] > 0);
+                searchParent[rt] = rs;
+                liveSearches[rs] += liveSearches[rt];
+                liveGroups[a] += liveSearches[rs] > 0;
+            }
+            if (search.head == search.nodes.size()) {
+                uint r = findSearch(s);
+                liveSearches[r]--;
+                if (liveSearches[r] == 0) liveGroups[a]--;
+            }
+        }
+    }
+}
+
+uint LargestCommonConnectedSubgraph::addPiece(PieceKind kind, uint comp, uint size) {
+    Piece piece;
+    piece.kind = kind;
+    piece.comp = comp;
+    pieces.push_back(piece);
+    pieceParent.push_back(pieces.size()-1);
+    pieceSize.push_back(size);
+    return pieces.size()-1;
+}
+
+uint LargestCommonConnectedSubgraph::findPiece(uint p) {
+    while (pieceParent[p] != p) {
+        pieceParent[p] = pieceParent[pieceParent[p]];
+        p = pieceParent[p];
+    }
+    return p;
+}
+
+void LargestCommonConnectedSubgraph::unitePieces(uint p, uint q) {
+    p = findPiece(p);
+    q = findPiece(q);
+    if (p == q) return;
+    pieceParent[q] = p;
+    pieceSize[p] += pieceSize[q];
+}
+
+//piece of a node after the edges of the moved nodes are removed
+uint LargestCommonConnectedSubgraph::pieceOf(uint node) {
+    if (node == movedNodes[0]) return movedPiece[0];
+    if (numMoved == 2 and node == movedNodes[1]) return movedPiece[1];
+    if (visitStamp[node] == stamp) {
+        uint s = visitSearch[node];
+        uint r = findSearch(s);
+        if (liveSearches[r] == 0) return searchPiece[r];
+        return restPiece[searches[s].affected];
+    }
+    uint c = comp[node];
+    for (uint a = 0; a < numAffected; a++) {
+        if (c == affectedComps[a]) return restPiece[a];
+    }
+    if (compStamp[c] != stamp) {
+        compStamp[c] = stamp;
+        compPiece[c] = addPiece(COMPONENT, c, members[c].size());
+    }
+    return compPiece[c];
+}
+
+uint LargestCommonConnectedSubgraph::proposeMove(const vector<uint>& A) {
+    const vector<vector<uint> >& adjLists = G1->getAdjLists();
+    const Matrix<MATRIX_UNIT>& G2Matrix = G2->getMatrix();
+    nextStamp();
+    numAffected = 0;
+    for (uint i = 0; i < numMoved; i++) {
+        uint c = comp[movedNodes[i]];
+        if (numAffected == 0 or affectedComps[0] != c) affectedComps[numAffected++] = c;
+        visitStamp[movedNodes[i]] = stamp;
+        visitSearch[movedNodes[i]] = NONE;
+    }
+
+    //a search from each old common neighbor of the moved nodes
+    numSearches = 0;
+    liveGroups[0] = liveGroups[1] = 0;
+    for (uint i = 0; i < numMoved; i++) {
+        uint m = movedNodes[i];
+        uint a = (comp[m] == affectedComps[0]) ? 0 : 1;
+        for (uint y : adjLists[m]) {
+            if (visitStamp[y] != stamp and G2Matrix.get(A[m], A[y])) startSearch(y, a);
+        }
+    }
+    runSearches(A);
+
+    //the pieces left when the moved nodes lose their edges
+    pieces.clear();
+    pieceParent.clear();
+    pieceSize.clear();
+    uint restSize[2];
+    for (uint a = 0; a < numAffected; a++) restSize[a] = members[affectedComps[a]].size();
+    for (uint i = 0; i < numMoved; i++) {
+        restSize[(comp[movedNodes[i]] == affectedComps[0]) ? 0 : 1]--;
+        movedPiece[i] = addPiece(MOVED, NONE, 1);
+    }
+    for (uint s = 0; s < numSearches; s++) searchPiece[s] = NONE;
+    for (uint s = 0; s < numSearches; s++) {
+        uint r = findSearch(s);
+        if (liveSearches[r] > 0) continue;
+        if (searchPiece[r] == NONE) searchPiece[r] = addPiece(GROUP, NONE, 0);
+        uint size = searches[s].nodes.size();
+        pieceSize[searchPiece[r]] += size;
+        restSize[searches[s].affected] -= size;
+    }
+    for (uint a = 0; a < numAffected; a++) restPiece[a] = addPiece(REST, affectedComps[a], restSize[a]);
+
+    //joined by the new edges of the moved nodes
+    for (uint i = 0; i < numMoved; i++) {
+        uint m = movedNodes[i];
+        for (uint y : adjLists[m]) {
+            if (G2Matrix.get(movedTargets[i], newTarget(A, y))) unitePieces(movedPiece[i], pieceOf(y));
+        }
+    }
+
+    uint largest = 0;
+    vector<uint>& replaced = replacedSizes; //old sizes of the components that changed
+    replaced.clear();
+    for (uint p = 0; p < pieces.size(); p++) {
+        if (findPiece(p) == p) largest = max(largest, pieceSize[p]);
+        if (pieces[p].kind == REST or pieces[p].kind == COMPONENT) {
+            replaced.push_back(members[pieces[p].comp].size());
+        }
+    }
+    for (auto it = compSizes.rbegin(); it != compSizes.rend(); it++) {
+        auto found = find(replaced.begin(), replaced.end(), *it);
+        if (found == replaced.end()) {
+            largest = max(largest, *it);
+            break;
+        }
+        replaced.erase(found);
+    }
+    return largest;
+}
+
+void LargestCommonConnectedSubgraph::attach(uint node, uint c) {
+    comp[node] = c;
+    pos[node] = members[c].size();
+    members[c].push_back(node);
+}
+
+void LargestCommonConnectedSubgraph::detach(uint node) {
+    vector<uint>& nodes = members[comp[node]];
+    uint last = nodes.back();
+    nodes[pos[node]] = last;
+    pos[last] = pos[node];
+    nodes.pop_back();
+}
+
+void LargestCommonConnectedSubgraph::commitMove() {
+    for (const Piece& piece : pieces) {
+        if (piece.kind == REST or piece.kind == COMPONENT) {
+            compSizes.erase(compSizes.find(members[piece.comp].size()));
+        }
+    }
+    for (uint i = 0; i < numMoved; i++) detach(movedNodes[i]);
+    for (uint s = 0; s < numSearches; s++) {
+        if (liveSearches[findSearch(s)] > 0) continue;
+        for (uint node : searches[s].nodes) detach(node);
+    }
+
+    //each group of pieces keeps the largest component it contains, so only
+    //the smaller pieces are moved
+    keeper.assign(pieces.size(), NONE);
+    for (uint p = 0; p < pieces.size(); p++) {
+        Piece& piece = pieces[p];
+        if (piece.kind != REST and piece.kind != COMPONENT) continue;
+        if (members[piece.comp].empty()) {
+            freeComps.push_back(piece.comp);
+            piece.comp = NONE;
+            continue;
+        }
+        uint r = findPiece(p);
+        if (keeper[r] == NONE or members[piece.comp].size() > members[keeper[r]].size()) keeper[r] = piece.comp;
+    }
+    for (uint p = 0; p < pieces.size(); p++) {
+        uint r = findPiece(p);
+        if (keeper[r] == NONE and pieceSize[r] > 0) {
+            keeper[r] = freeComps.back();
+            freeComps.pop_back();
+        }
+    }
+    for (uint p = 0; p < pieces.size(); p++) {
+        const Piece& piece = pieces[p];
+        if (piece.comp == NONE) continue;
+        uint k = keeper[findPiece(p)];
+        if (piece.comp == k) continue;
+        for (uint node : members[piece.comp]) attach(node, k);
+        members[piece.comp].clear();
+        freeComps.push_back(piece.comp);
+    }
+    for (uint i = 0; i < numMoved; i++) attach(movedNodes[i], keeper[findPiece(movedPiece[i])]);
+    for (uint s = 0; s < numSearches; s++) {
+        uint r = findSearch(s);
+        if (liveSearches[r] > 0) continue;
+        uint k = keeper[findPiece(searchPiece[r])];
+        for (uint node : searches[s].nodes) attach(node, k);
+    }
+    for (uint p = 0; p < pieces.size(); p++) {
+        if (findPiece(p) == p and pieceSize[p] > 0) compSizes.insert(members[keeper[p]].size());
+    }
+    numMoved = 0;
+    pieces.clear();
+    numSearches = 0;
+}
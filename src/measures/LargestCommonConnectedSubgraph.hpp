@@ -1,13 +1,32 @@
 #ifndef LARGESTCOMMONCONNECTEDSUBGRAPH_HPP
 #define LARGESTCOMMONCONNECTEDSUBGRAPH_HPP
+#include <set>
 #include "Measure.hpp"
 
 class LargestCommonConnectedSubgraph: public Measure {
 public:
-    LargestCommonConnectedSubgraph(Graph* G1, Graph* G2);
+    //named "lccs" with the MAGNA definition and "lccsn" with nodeProportion
+    LargestCommonConnectedSubgraph(Graph* G1, Graph* G2, bool magnaDefinition = true);
     virtual ~LargestCommonConnectedSubgraph();
     double eval(const Alignment& A);
     double nodeProportion(const Alignment& A); //"normal" measure
+
+    //Incremental size of the largest connected component of the common
+    //subgraph, for SANA. initIncremental finds the components of A; the
+    //Op functions return the size after a move of A without applying it, and
+    //commitMove applies the last move proposed (A itself is updated by the
+    //caller). A move only splits the components of the moved nodes, so a
+    //search is started from each of their old common neighbors and the
+    //searches grow in turns until at most one of them per component is not
+    //exhausted: the cost is that of the pieces cut off, not of the component.
+    void initIncremental(const vector<uint>& A);
+    uint largestSize() const;
+    //source moves to the unassigned newTarget
+    uint changeOpLargest(const vector<uint>& A, uint source, uint newTarget);
+    //source1 and source2 swap targets
+    uint swapOpLargest(const vector<uint>& A, uint source1, uint source2);
+    void commitMove();
+
 private:
 
     /*
@@ -23,8 +42,59 @@ private:
     that are in the subgraph of G2 that is induced on
     the nodes from the LCCS.
     */
-    static bool const USE_MAGNA_DEFINITION = true;
+    bool magnaDefinition;
+
+    //components of the common subgraph of the incremental alignment
+    vector<uint> comp, pos; //component of each node and its index in members
+    vector<vector<uint> > members;
+    vector<uint> freeComps;
+    multiset<uint> compSizes;
+
+    //the last move proposed
+    uint movedNodes[2], movedTargets[2], numMoved;
+    uint affectedComps[2], numAffected;
+    uint stamp;
+    vector<uint> visitStamp, visitSearch, compStamp, compPiece;
+
+    struct Search {
+        uint affected; //index in affectedComps
+        uint head;     //nodes[head..] are still to be expanded
+        vector<uint> nodes;
+    };
+    vector<Search> searches;
+    uint numSearches;
+    vector<uint> searchParent, liveSearches; //union-find of the searches that met
+    uint liveGroups[2];
+
+    //pieces the affected components split into, joined by the new edges
+    enum PieceKind {
+        REST,      //what is left of an affected component, never enumerated
+        COMPONENT, //an untouched component reached by a new edge
+        GROUP,     //the nodes of exhausted searches that met
+        MOVED      //a moved node
+    };
+    struct Piece {
+        PieceKind kind;
+        uint comp; //REST and COMPONENT
+    };
+    vector<Piece> pieces;
+    vector<uint> pieceParent, pieceSize; //union-find of the pieces that were joined
+    vector<uint> searchPiece, keeper, replacedSizes;
+    uint restPiece[2], movedPiece[2];
+
+    uint proposeMove(const vector<uint>& A);
+    void nextStamp();
+    void startSearch(uint node, uint affected);
+    void runSearches(const vector<uint>& A);
+    uint findSearch(uint s);
+    uint findPiece(uint p);
+    void unitePieces(uint p, uint q);
+    uint pieceOf(uint node);
+    uint addPiece(PieceKind kind, uint comp, uint size);
+    uint newTarget(const vector<uint>& A, uint node) const;
+    bool isMoved(uint node) const;
+    void attach(uint node, uint c);
+    void detach(uint node);
 };
 
 #endif
-
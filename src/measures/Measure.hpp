@@ -14,6 +14,9 @@ public:
     virtual double eval(const Alignment& A) =0;
     string getName();
     virtual bool isLocal();
+    //false for the measures whose eval reads or writes files, which are
+    //evaluated one at a time
+    virtual bool isThreadSafe() { return true; }
     virtual double balanceWeight() {return 0;};
     
     virtual vector<uint> getMappingforNC() const {return vector<uint>{0};}
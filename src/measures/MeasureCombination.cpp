@@ -5,6 +5,7 @@
 #include <iterator>
 #include <string>
 #include <functional>
+#include <atomic>
 
 MeasureCombination::MeasureCombination(){
 }
@@ -37,6 +38,30 @@ double MeasureCombination::eval(const string& measureName, const Alignment& A) c
     return 0;
 }
 
+vector<double> MeasureCombination::evalAll(const Alignment& A) const {
+    uint n = measures.size();
+    vector<double> scores(n);
+    atomic<uint> next(0);
+    auto worker = [&]() {
+        for (uint i = next++; i < n; i = next++) {
+            if (measures[i]->isThreadSafe()) scores[i] = measures[i]->eval(A);
+        }
+    };
+    uint numThreads = min(n, max(1u, thread::hardware_concurrency()));
+    vector<thread> threads;
+    for (uint t = 1; t < numThreads; t++) {
+        threads.push_back(thread(worker));
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (uint i = 0; i < n; i++) {
+        if (not measures[i]->isThreadSafe()) scores[i] = measures[i]->eval(A);
+    }
+    return scores;
+}
+
 void MeasureCombination::addMeasure(Measure* m, double weight) {
     measures.push_back(m);
     weights.push_back(weight);
@@ -101,16 +126,21 @@ void MeasureCombination::printWeights(ostream& ofs) const {
 
 void MeasureCombination::printMeasures(const Alignment& A, ostream& ofs) const {
     uint n = measures.size();
+    vector<double> scores = evalAll(A);
     for (uint i = 0; i < n; i++) {
         ofs << measures[i]->getName();
-        ofs << ": " << measures[i]->eval(A) << endl;
+        ofs << ": " << scores[i] << endl;
     }
     uint count = 0;
+    double combined = 0; //as eval(A) adds them
     for (uint i = 0; i < n; i++) {
-        if (weights[i] > 0) count++;
+        if (weights[i] > 0) {
+            count++;
+            combined += scores[i] * weights[i];
+        }
     }
     if (count > 1) {
-        ofs << "Combined: " << eval(A) << " ( ";
+        ofs << "Combined: " << combined << " ( ";
         for (uint i = 0; i < n; i++) {
             if (weights[i] > 0) ofs << measures[i]->getName() << " " << weights[i] << " ";
         }
@@ -196,45 +226,51 @@ void MeasureCombination::initn1n2(uint& n1, uint& n2) const {
     for (uint i = 0; i < numMeasures(); i++) {
         Measure* m = measures[i];
         if (m->isLocal()) {
-            vector<vector<float> >* mSims = ((LocalMeasure*) m)->getSimMatrix();
-            n1 = mSims->size();
-            n2 = (*mSims)[0].size();
+            SimMatrix* mSims = ((LocalMeasure*) m)->getSimMatrix();
+            n1 = mSims->numRows();
+            n2 = mSims->numCols();
             return;
         }
     }
     throw runtime_error("There are no local measures");
 }
 
-typedef vector<vector<float> > SimMatrix;
-typedef function<void(SimMatrix &, uint const &, uint const &)> SimMatrixRecipe;
+typedef function<void(float*, uint const &, uint const &)> SimMatrixRecipe;
 
 //Returns a reference to the similarity matrix of the weighted sum of local measures.
 //Only initializes the matrix on the first call.
-vector<vector<float> >& MeasureCombination::getAggregatedLocalSims() {
+SimMatrix& MeasureCombination::getAggregatedLocalSims() {
     //A flag to check if the map has been initialized.
     static bool is_init = false;
-    //The "recipe" that describes how to create the sim matrix,
+    //The "recipe" that describes how to create a row of the sim matrix,
     //namely to combine all locals into a new localdo.
-    static function<void(vector<vector<float> > &, uint const &, uint const &)> const initFunc =
-      [this] (vector<vector<float> > & sim, uint const & n1, uint const & n2) {
-        Measure* m;
-        double w;
-        for (uint i = 0; i < numMeasures(); i++) {
-            m = measures[i];
-            w = weights[i];
+    static SimMatrixRecipe const initFunc =
+      [this] (float* row, uint const & i, uint const & n2) {
+        for (uint k = 0; k < numMeasures(); k++) {
+            Measure* m = measures[k];
+            double w = weights[k];
             if (m->isLocal() and w > 0) {
-                vector<vector<float> >* mSims = ((LocalMeasure*) m)->getSimMatrix();
-                for (uint i = 0; i < n1; i++) {
-                    for (uint j = 0; j < n2; j++) {
-                        sim[i][j] += w * (*mSims)[i][j];
-                    }
+                const SimMatrix& mSims = *((LocalMeasure*) m)->getSimMatrix();
+                SimMatrix::ConstRow mRow = mSims[i];
+                for (uint j = 0; j < n2; j++) {
+                    row[j] += w * mRow[j];
                 }
             }
         }
       };
     if(!is_init) {
       is_init = true;
-      localAggregatedSim = initSim(initFunc);
+      //the weighted sum of the ranges of the measures bounds its range
+      float lo = 0, hi = 0;
+      for (uint k = 0; k < numMeasures() and LocalMeasure::getSimBits() < 32; k++) {
+          if (measures[k]->isLocal() and weights[k] > 0) {
+              float mLo, mHi;
+              ((LocalMeasure*) measures[k])->getSimMatrix()->valueRange(mLo, mHi);
+              lo += weights[k] * mLo;
+              hi += weights[k] * mHi;
+          }
+      }
+      localAggregatedSim = initSim(initFunc, lo, hi);
     }
     return localAggregatedSim;
 }
@@ -248,13 +284,12 @@ map<string, SimMatrix>& MeasureCombination::getLocalSimMap() {
     //A flag to check if the map has been initialized.
     static bool is_init = false;
     //The "recipe" that describes how to create the sim matrix.
-    static SimMatrixRecipe const initFunc =
-        [this, &m, &w] (SimMatrix & sim, uint const & n1, uint const & n2) {
-            SimMatrix* mSims = ((LocalMeasure*) m)->getSimMatrix();
-            for (uint i = 0; i < n1; i++) {
-                for (uint j = 0; j < n2; j++) {
-                    sim[i][j] = w * (*mSims)[i][j];
-                }
+    SimMatrixRecipe const initFunc =
+        [&m, &w] (float* row, uint const & i, uint const & n2) {
+            const SimMatrix& mSims = *((LocalMeasure*) m)->getSimMatrix();
+            SimMatrix::ConstRow mRow = mSims[i];
+            for (uint j = 0; j < n2; j++) {
+                row[j] = w * mRow[j];
             }
         };
     if(!is_init) {
@@ -263,7 +298,11 @@ map<string, SimMatrix>& MeasureCombination::getLocalSimMap() {
           m = measures[i];
           w = weights[i];
           if (m->isLocal() and w > 0) {
-              localScoreSimMap[m->getName()] = initSim(initFunc);
+              float lo = 0, hi = 0;
+              if (LocalMeasure::getSimBits() < 32) {
+                  ((LocalMeasure*) m)->getSimMatrix()->valueRange(lo, hi);
+              }
+              localScoreSimMap[m->getName()] = initSim(initFunc, w * lo, w * hi);
           }
       }
     }
@@ -273,12 +312,18 @@ map<string, SimMatrix>& MeasureCombination::getLocalSimMap() {
 //Abstracts the construction of the similarity matrix. Instead of the get..()
 //functions producing possibly different implementations of similarity matrices,
 //a common type of similarity matrix is produced in initSim and populated
-//by a Recipe function.
-SimMatrix MeasureCombination::initSim(SimMatrixRecipe recipe) const {
+//one row at a time by a Recipe function. The matrix has the bits per entry
+//of the local measures; [lo, hi] must cover its values if it is quantized.
+SimMatrix MeasureCombination::initSim(SimMatrixRecipe recipe, float lo, float hi) const {
   static uint n1 = 0, n2 = 0;
   initn1n2(n1, n2);
-  vector<vector<float> > sim(n1, vector<float> (n2, 0));
-  recipe(sim, n1, n2);
+  SimMatrix sim(n1, n2, LocalMeasure::getSimBits(), lo, hi);
+  vector<float> row(n2);
+  for (uint i = 0; i < n1; i++) {
+    fill(row.begin(), row.end(), 0);
+    recipe(row.data(), i, n2);
+    sim.setRow(i, row.data());
+  }
   return sim;
 }
 
@@ -12,6 +12,7 @@
 #include <iomanip>
 
 #include "Measure.hpp"
+#include "../utils/SimMatrix.hpp"
 
 class MeasureCombination {
 public:
@@ -19,6 +20,8 @@ public:
     ~MeasureCombination();
     double eval(const Alignment& A) const;
     double eval(const string& measureName, const Alignment& A) const;
+    //score of every measure, in order, evaluating them concurrently
+    vector<double> evalAll(const Alignment& A) const;
     void addMeasure(Measure* m, double weight);
     void addMeasure(Measure* m);
     void printWeights(ostream& ofs) const;
@@ -36,8 +39,8 @@ public:
     //to private variables, similar to C# get {}
     //The const postfix has been therefore been removed
     //because these functions can lead to state changes.
-    vector<vector<float> >& getAggregatedLocalSims();
-    map<string, vector<vector<float> > >& getLocalSimMap();
+    SimMatrix& getAggregatedLocalSims();
+    map<string, SimMatrix>& getLocalSimMap();
 
     int getNumberOfLocalMeasures() const;
     void rebalanceWeight(string& input);
@@ -66,8 +69,7 @@ public:
     unsigned int getParetoThreads() {return paretoThreads;}
 
 private:
-    typedef vector<vector<float> > SimMatrix;
-    typedef function<void(SimMatrix &, uint const &, uint const &)> SimMatrixRecipe;
+    typedef function<void(float*, uint const &, uint const &)> SimMatrixRecipe;
     vector<Measure*> measures;
     vector<double> weights;
     SimMatrix localAggregatedSim;
@@ -78,8 +80,8 @@ private:
     //Abstracts the construction of the similarity matrix. Instead of the get..()
     //functions producing possibly different implementations of similarity matrices,
     //a common type of similarity matrix is produced in initSim and populated
-    //by a Recipe function.
-    vector<vector<float> > initSim(SimMatrixRecipe Recipe) const;
+    //one row at a time by a Recipe function.
+    SimMatrix initSim(SimMatrixRecipe Recipe, float lo, float hi) const;
 
     void clearWeights();
     void setWeight(const string& measureName, double weight);
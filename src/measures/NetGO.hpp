@@ -8,6 +8,7 @@ public:
     NetGO(Graph* G1, Graph* G2);
     virtual ~NetGO();
     double eval(const Alignment& A);
+    bool isThreadSafe() { return false; }
 private:
     bool NORMALIZE;
     double Permutation(uint M, uint N);
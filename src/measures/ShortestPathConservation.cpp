@@ -1,40 +1,119 @@
 #include <cmath>
 #include <vector>
 #include <iostream>
+#include <thread>
+#include <atomic>
 #include "ShortestPathConservation.hpp"
 
+//largest finite distance
+static uint maxFiniteDistance(const Graph::DistanceMatrix& dist, uint n) {
+    uint res = 0;
+    for (uint i = 0; i < n; i++) {
+        for (uint j = 0; j < n; j++) {
+            uint8_t d = dist.get(i, j);
+            if (d != Graph::INFINITE_DISTANCE and d > res) res = d;
+        }
+    }
+    return res;
+}
+
 ShortestPathConservation::ShortestPathConservation(Graph* G1, Graph* G2) : Measure(G1, G2, "spc") {
     
     G1->getDistanceMatrix(distMatrixG1);
     G2->getDistanceMatrix(distMatrixG2);
-    uint maxDistG1 = matrixMax(distMatrixG1);
-    uint maxDistG2 = matrixMax(distMatrixG2);
+    uint maxDistG1 = maxFiniteDistance(distMatrixG1, G1->getNumNodes());
+    uint maxDistG2 = maxFiniteDistance(distMatrixG2, G2->getNumNodes());
     maxDist = max(maxDistG1, maxDistG2);
 }
 
 ShortestPathConservation::~ShortestPathConservation() {
 }
 
-double ShortestPathConservation::eval(const Alignment& A) {
+uint64_t ShortestPathConservation::distanceDifferenceSum(const Alignment& A, uint iBegin, uint iEnd) const {
     uint n1 = G1->getNumNodes();
-    uint total = 0;
-    for (uint i = 0; i < n1; i++) {
+    uint64_t total = 0;
+    for (uint i = iBegin; i < iEnd; i++) {
+        const uint8_t* row1 = distMatrixG1.row(i);
+        const uint8_t* row2 = distMatrixG2.row(A[i]);
         for (uint j = i+1; j < n1; j++) {
-            short dist1 = distMatrixG1[i][j];
-            short dist2 = distMatrixG2[A[i]][A[j]];
-            if (dist1 == -1 and dist2 == -1) {
-                total += 0;
-            }
-            else if (dist1 == -1 or dist2 == -1) {
-                total += maxDist;
-            }
-            else {
-                total += abs(dist1-dist2);
-            }
+            total += pairCost(row1[j], row2[A[j]]);
         }
     }
-    uint numPairs = binomialCoefficient(n1, 2);
+    return total;
+}
 
-    if (NORMALIZE) return 1 - (double) total/(numPairs*maxDist);
-    else return (double) total/numPairs;
+uint64_t ShortestPathConservation::distanceDifferenceSum(const Alignment& A) const {
+    //rows get shorter as i grows, so they are handed out in small blocks
+    const uint ROW_BLOCK = 64;
+    uint n1 = G1->getNumNodes();
+    atomic<uint> nextRow(0);
+    atomic<uint64_t> total(0);
+    auto worker = [&]() {
+        uint64_t sum = 0;
+        for (uint iBegin = nextRow.fetch_add(ROW_BLOCK); iBegin < n1; iBegin = nextRow.fetch_add(ROW_BLOCK)) {
+            sum += distanceDifferenceSum(A, iBegin, min(n1, iBegin + ROW_BLOCK));
+        }
+        total += sum;
+    };
+    uint numThreads = max(1u, thread::hardware_concurrency());
+    vector<thread> threads;
+    for (uint t = 1; t < numThreads; t++) {
+        threads.push_back(thread(worker));
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+    return total;
+}
+
+double ShortestPathConservation::score(double differenceSum) const {
+    uint n1 = G1->getNumNodes();
+    double numPairs = (double) n1 * (n1 - 1) / 2;
+
+    if (NORMALIZE) return maxDist == 0 ? 1 : 1 - differenceSum/(numPairs*maxDist);
+    else return differenceSum/numPairs;
+}
+
+double ShortestPathConservation::eval(const Alignment& A) {
+    return score(distanceDifferenceSum(A));
+}
+
+//Both deltas sum over every j and then take out the terms of the moved nodes,
+//so the loops have no branches. Only the pairs with a moved node change.
+int64_t ShortestPathConservation::changeOpDelta(const vector<uint>& A, uint source, uint oldTarget, uint newTarget) const {
+    uint n1 = G1->getNumNodes();
+    const uint8_t* row1 = distMatrixG1.row(source);
+    const uint8_t* oldRow = distMatrixG2.row(oldTarget);
+    const uint8_t* newRow = distMatrixG2.row(newTarget);
+    const uint* Ap = A.data();
+    int64_t delta = 0;
+    for (uint j = 0; j < n1; j++) {
+        uint8_t dist1 = row1[j];
+        uint Aj = Ap[j];
+        delta += pairCost(dist1, newRow[Aj]) - pairCost(dist1, oldRow[Aj]);
+    }
+    //j = source, where A[j] = oldTarget
+    delta -= pairCost(0, newRow[oldTarget]);
+    return delta;
+}
+
+int64_t ShortestPathConservation::swapOpDelta(const vector<uint>& A, uint source1, uint source2, uint target1, uint target2) const {
+    uint n1 = G1->getNumNodes();
+    const uint8_t* row11 = distMatrixG1.row(source1);
+    const uint8_t* row12 = distMatrixG1.row(source2);
+    const uint8_t* row21 = distMatrixG2.row(target1);
+    const uint8_t* row22 = distMatrixG2.row(target2);
+    const uint* Ap = A.data();
+    auto term = [&](uint j) -> int {
+        uint8_t dist11 = row11[j], dist12 = row12[j];
+        uint8_t dist21 = row21[Ap[j]], dist22 = row22[Ap[j]];
+        return pairCost(dist11, dist22) - pairCost(dist11, dist21) + pairCost(dist12, dist21) - pairCost(dist12, dist22);
+    };
+    int64_t delta = 0;
+    for (uint j = 0; j < n1; j++) {
+        delta += term(j);
+    }
+    //the distance between the swapped nodes does not change
+    return delta - term(source1) - term(source2);
 }
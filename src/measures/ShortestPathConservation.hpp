@@ -8,12 +8,35 @@ public:
     virtual ~ShortestPathConservation();
     double eval(const Alignment& A);
 
+    //sum over the pairs of G1 nodes of the difference between their distance
+    //and the distance of their images (maxDist if only one is infinite)
+    uint64_t distanceDifferenceSum(const Alignment& A) const;
+    //the score for a given distanceDifferenceSum
+    double score(double differenceSum) const;
+
+    //change of distanceDifferenceSum if source moves from oldTarget to the
+    //unassigned newTarget, and if source1 and source2 swap targets. O(n1).
+    int64_t changeOpDelta(const vector<uint>& A, uint source, uint oldTarget, uint newTarget) const;
+    int64_t swapOpDelta(const vector<uint>& A, uint source1, uint source2, uint target1, uint target2) const;
+
 private:
-    vector<vector<short> > distMatrixG1, distMatrixG2;
+    Graph::DistanceMatrix distMatrixG1, distMatrixG2;
     uint maxDist;
 
-    static const bool NORMALIZE = false;
+    //sum of the distance differences of the pairs (i, j), j > i, of the rows i in [iBegin, iEnd)
+    uint64_t distanceDifferenceSum(const Alignment& A, uint iBegin, uint iEnd) const;
+
+    //branch-free so that the O(n1) loops of the deltas vectorize
+    int pairCost(uint8_t dist1, uint8_t dist2) const {
+        const uint8_t INF = Graph::INFINITE_DISTANCE;
+        int diff = abs((int) dist1 - (int) dist2);
+        int infinite = (dist1 == INF) + (dist2 == INF);
+        return infinite == 0 ? diff : (infinite == 1 ? (int) maxDist : 0);
+    }
+
+    //1 - the average difference over maxDist, so that higher is better like
+    //the other measures and SANA can maximize it
+    static const bool NORMALIZE = true;
 };
 
 #endif
-
@@ -14,24 +14,38 @@ TriangleCorrectness::TriangleCorrectness(Graph* G1, Graph* G2) : Measure(G1, G2,
 TriangleCorrectness::~TriangleCorrectness() {
 }
 
+//triangles of G1 with their three edges aligned to edges, i.e., the triangles
+//of A.commonSubgraph(*G1, *G2), without building it
 double TriangleCorrectness::eval(const Alignment& A){
-    Graph inducedSubgraph = A.commonSubgraph(*G1, *G2);
-    return ((double)calculateTriangles(&inducedSubgraph)/(maxTriangles));
+    const vector<vector<uint> >& G1AdjLists = G1->getAdjLists();
+    const Matrix<MATRIX_UNIT>& G1Matrix = G1->getMatrix();
+    const Matrix<MATRIX_UNIT>& G2Matrix = G2->getMatrix();
+    int numTriangles = 0;
+    for(uint i = 0; i < G1->getNumNodes(); i++){
+        for(uint j : G1AdjLists[i]){
+            if(j < i or not G2Matrix.get(A[i], A[j])) continue;
+            for(uint k : G1AdjLists[i]){
+                if(k > j and G2Matrix.get(A[i], A[k]) and
+                        G1Matrix.get(j, k) and G2Matrix.get(A[j], A[k])){
+                    numTriangles++;
+                }
+            }
+        }
+    }
+    return ((double)numTriangles/(maxTriangles));
 }
 
-int TriangleCorrectness::calculateTriangles(Graph* G){
+int TriangleCorrectness::calculateTriangles(const Graph* G){
     int numTriangles = 0;
-    vector<vector<uint> > GAdjLists;
-    Matrix<MATRIX_UNIT> GMatrix;
-    G->getAdjLists(GAdjLists);
-    G->getMatrix(GMatrix);
+    const vector<vector<uint> >& GAdjLists = G->getAdjLists();
+    const Matrix<MATRIX_UNIT>& GMatrix = G->getMatrix();
     for(uint i = 0; i < G->getNumNodes(); i++){
         for(uint j = 0; j < GAdjLists[i].size(); j++){
             for(uint k = 0; k < GAdjLists[i].size(); k++){
                 if(k != j){
                     uint neighbor1 = GAdjLists[i][j];
                     uint neighbor2 = GAdjLists[i][k];
-                    if(GMatrix[neighbor1][neighbor2]){
+                    if(GMatrix.get(neighbor1, neighbor2)){
                         numTriangles++;
                     }
                 }
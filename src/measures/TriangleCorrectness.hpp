@@ -9,7 +9,7 @@ public:
     double eval(const Alignment& A);
     int getMaxTriangles();
 private:
-    int calculateTriangles(Graph* G);
+    int calculateTriangles(const Graph* G);
     Graph* GSmaller;
     int maxTriangles;
 };
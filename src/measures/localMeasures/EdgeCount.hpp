@@ -9,6 +9,8 @@ public:
 private:
     vector<double> distWeights;
     void initSimMatrix();
+    vector<vector<uint> > densities(Graph* G, uint k);
+    bool isTopological() { return true; }
 };
 
 #endif
@@ -2,6 +2,7 @@
 #include <iostream>
 #include "ExternalSimMatrix.hpp"
 #include "../../utils/utils.hpp"
+#include "../../utils/SimMatrixFile.hpp"
 #include <string>
 using namespace std;
 
@@ -16,12 +17,13 @@ ExternalSimMatrix::ExternalSimMatrix(Graph* G1, Graph* G2, string file, int form
 void ExternalSimMatrix::initSimMatrix() {
     uint n1 = G1->getNumNodes();
     uint n2 = G2->getNumNodes();
-    sims = vector<vector<float> > (n1, vector<float> (n2, 0));
+    sims = SimMatrix(n1, n2);
 
     switch(format) {
     case 0:    loadFormat0();    break;
     case 1:    loadFormat1();    break;
     case 2: loadFormat2();  break;
+    case 3: SimMatrixFile::readBinary(file, sims); break;
     default:                break;
     }
 
@@ -33,7 +35,7 @@ void ExternalSimMatrix::loadFormat0() {
     for(uint i = 0; i < words.size(); i +=3) {
         int n = atoi(words[i].c_str());
         int m = atoi(words[i+1].c_str());
-        sims[n][m] = stod(words[i+2]);
+        sims.writableRow(n)[m] = stod(words[i+2]);
      }
 }
 
@@ -45,7 +47,7 @@ void ExternalSimMatrix::loadFormat1() {
     for(uint i = 0; i < words.size(); i +=3) {
         uint n = g1Map[words[i]];
         uint m = g2Map[words[i+1]];
-        sims[n][m] = stod(words[i+2]);
+        sims.writableRow(n)[m] = stod(words[i+2]);
     }
 }
 
@@ -54,7 +56,7 @@ void ExternalSimMatrix::loadFormat2() {
     for(uint i = 0; i < G1->getNumNodes(); i++){
         for(uint j = 0; j < G2->getNumNodes(); j++){
             double sim = stod(words[i*G2->getNumNodes() + j]);
-            sims[i][j] = sim;
+            sims.writableRow(i)[j] = sim;
         }
     }
 }
@@ -1,15 +1,8 @@
 #include <vector>
 #include "GenericLocalMeasure.hpp"
 
-GenericLocalMeasure::GenericLocalMeasure(Graph* G1, Graph* G2, string name, const vector<vector<float> >& simMatrix) : LocalMeasure(G1, G2, name) {
-    uint n1 = G1->getNumNodes();
-    uint n2 = G2->getNumNodes();
-    sims = vector<vector<float> > (n1, vector<float> (n2));
-    for (uint i = 0; i < n1; i++) {
-        for (uint j = 0; j < n2; j++) {
-            sims[i][j] = simMatrix[i][j];
-        }
-    }
+GenericLocalMeasure::GenericLocalMeasure(Graph* G1, Graph* G2, string name, SimMatrix&& simMatrix) : LocalMeasure(G1, G2, name) {
+    sims = move(simMatrix);
 }
 
 void GenericLocalMeasure::initSimMatrix() {
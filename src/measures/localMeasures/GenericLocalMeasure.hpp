@@ -4,7 +4,7 @@
 
 class GenericLocalMeasure: public LocalMeasure {
 public:
-    GenericLocalMeasure(Graph* G1, Graph* G2, string name, const vector<vector<float> >& simMatrix);
+    GenericLocalMeasure(Graph* G1, Graph* G2, string name, SimMatrix&& simMatrix);
     virtual ~GenericLocalMeasure();
 private:
 
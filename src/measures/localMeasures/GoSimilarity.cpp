@@ -218,7 +218,7 @@ vector<vector<uint> > GoSimilarity::loadGOTerms(
 void GoSimilarity::initSimMatrix() {
     uint n1 = G1->getNumNodes();
     uint n2 = G2->getNumNodes();
-    sims = vector<vector<float> > (n1, vector<float> (n2, 0));
+    sims = SimMatrix(n1, n2);
 
     vector<vector<uint> > G1GOTerms = loadGOTerms(*G1, occurrencesFraction);
     vector<vector<uint> > G2GOTerms = loadGOTerms(*G2, occurrencesFraction);
@@ -229,7 +229,7 @@ void GoSimilarity::initSimMatrix() {
         accumulativeWeights[i] += accumulativeWeights[i-1];
     }
 
-    sims = vector<vector<float> > (n1, vector<float> (n2, 0));
+    sims = SimMatrix(n1, n2);
     for (uint i = 0; i < n1; i++) {
         for (uint j = 0; j < n2; j++) {
             uint count = 0;
@@ -242,10 +242,10 @@ void GoSimilarity::initSimMatrix() {
                 }
             }
             if (count == 0) {
-                sims[i][j] = 0;
+                sims.writableRow(i)[j] = 0;
             }
             else {
-                sims[i][j] = accumulativeWeights[count-1];
+                sims.writableRow(i)[j] = accumulativeWeights[count-1];
             }
         }
     }
@@ -5,7 +5,8 @@
 using namespace std;
 
 Graphlet::Graphlet(Graph* G1, Graph* G2) : LocalMeasure(G1, G2, "graphlet") {
-    string fileName = autogenMatricesFolder+G1->getName()+"_"+G2->getName()+"_graphlet.bin";
+    string fileName = autogenMatricesFolder+G1->getName()+"_"+G2->getName()+"_graphlet"+
+        to_string((uint) G1->getMaxGraphletSize())+".bin";
     loadBinSimMatrix(fileName);
 }
 
@@ -47,21 +48,46 @@ double Graphlet::getOrbitWeightSum() {
 void Graphlet::initSimMatrix() {
     uint n1 = G1->getNumNodes();
     uint n2 = G2->getNumNodes();
-    sims = vector<vector<float> > (n1, vector<float> (n2, 0));
-    vector<vector<uint> > gdvs1 = G1->loadGraphletDegreeVectors();
-    vector<vector<uint> > gdvs2 = G2->loadGraphletDegreeVectors();
+    sims = SimMatrix(n1, n2);
+    vector<vector<uint> > gdvs1, gdvs2;
+    Graph::loadGraphletDegreeVectors(*G1, *G2, gdvs1, gdvs2);
 
-    vector<double> orbitWeights = getOrbitWeights();
-    double weightSum = getOrbitWeightSum();
+    //every log is taken once per node instead of once per pair. The
+    //denominator log2(max(a, b)+2) is max(log2(a+2), log2(b+2)) since log2 is
+    //increasing. G2's values are stored orbit-major, so the loop over a tile
+    //of G2 nodes is contiguous and vectorizes without reordering any sum.
+    vector<double> logGdvs1(n1*NUM_ORBITS), logNorms1(n1*NUM_ORBITS);
     for (uint i = 0; i < n1; i++) {
+        for (uint k = 0; k < NUM_ORBITS; k++) {
+            logGdvs1[i*NUM_ORBITS+k] = log2(gdvs1[i][k] + 1);
+            logNorms1[i*NUM_ORBITS+k] = log2(gdvs1[i][k] + 2);
+        }
+    }
+    vector<double> logGdvs2(NUM_ORBITS*n2), logNorms2(NUM_ORBITS*n2);
+    for (uint k = 0; k < NUM_ORBITS; k++) {
         for (uint j = 0; j < n2; j++) {
-            double orbitDistanceSum = 0;
-            for (uint k = 0; k < NUM_ORBITS; k++) {
-                orbitDistanceSum += orbitWeights[k] *
-                    abs(log2(gdvs1[i][k] + 1) - log2(gdvs2[j][k] + 1)) /
-                    log2(max(gdvs1[i][k], gdvs2[j][k]) + 2);
-            }
-            sims[i][j] = 1 - orbitDistanceSum/weightSum;
+            logGdvs2[k*n2+j] = log2(gdvs2[j][k] + 1);
+            logNorms2[k*n2+j] = log2(gdvs2[j][k] + 2);
         }
     }
+
+    vector<double> orbitWeights = getOrbitWeights();
+    double weightSum = getOrbitWeightSum();
+    forEachSimTile([&](uint i, uint jBegin, uint jEnd) {
+        uint tileSize = jEnd - jBegin;
+        double orbitDistanceSums[SIM_TILE_COLS] = {0};
+        for (uint k = 0; k < NUM_ORBITS; k++) {
+            double weight = orbitWeights[k];
+            double logGdv1 = logGdvs1[i*NUM_ORBITS+k];
+            double logNorm1 = logNorms1[i*NUM_ORBITS+k];
+            const double* logGdv2 = &logGdvs2[k*n2+jBegin];
+            const double* logNorm2 = &logNorms2[k*n2+jBegin];
+            for (uint j = 0; j < tileSize; j++) {
+                orbitDistanceSums[j] += weight * abs(logGdv1 - logGdv2[j]) / max(logNorm1, logNorm2[j]);
+            }
+        }
+        for (uint j = 0; j < tileSize; j++) {
+            sims.writableRow(i)[jBegin+j] = 1 - orbitDistanceSums[j]/weightSum;
+        }
+    });
 }
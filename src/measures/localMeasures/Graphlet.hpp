@@ -9,6 +9,7 @@ public:
 
 private:
     void initSimMatrix();
+    bool isTopological() { return true; }
 
     vector<double> getNumbersOfAffectedOrbits();
     vector<double> getOrbitWeights();
@@ -5,35 +5,14 @@
 using namespace std;
 
 GraphletCosine::GraphletCosine(Graph* G1, Graph* G2) : LocalMeasure(G1, G2, "graphletcosine") {
-    string fileName = autogenMatricesFolder+G1->getName()+"_"+G2->getName()+"_graphletcosine.bin";
+    string fileName = autogenMatricesFolder+G1->getName()+"_"+G2->getName()+"_graphletcosine"+
+        to_string((uint) G1->getMaxGraphletSize())+".bin";
     loadBinSimMatrix(fileName);
 }
 
 GraphletCosine::~GraphletCosine() {
 }
 
-double magnitude(vector<uint> vector) {
-    double res = 0;
-    for(uint i = 0; i < vector.size(); ++i) {
-        res += vector[i] * vector[i];
-    }
-
-    return sqrt(res);
-}
-
-double dot(vector<uint> v1, vector<uint> v2) {
-    double res = 0;
-    for(uint i = 0; i < v1.size(); ++i) {
-        res += v1[i] * v2[i];
-    }
-
-    return res;
-}
-
-double cosineSimilarity(vector<uint> v1, vector<uint> v2) {
-    return dot(v1, v2) / (magnitude(v1) * magnitude(v2));
-}
-
 vector<uint> reduce(vector<uint> v) {
     vector<uint> res(11);
     res[0] = v[0];
@@ -56,22 +35,48 @@ static bool shouldReduce = false;
 void GraphletCosine::initSimMatrix() {
     uint n1 = G1->getNumNodes();
     uint n2 = G2->getNumNodes();
-    sims = vector<vector<float> > (n1, vector<float> (n2, 0));
-    vector<vector<uint> > gdvs1 = G1->loadGraphletDegreeVectors();
-    vector<vector<uint> > gdvs2 = G2->loadGraphletDegreeVectors();
-
-    for (uint i = 0; i < n1; i++) {
-        for (uint j = 0; j < n2; j++) {
+    sims = SimMatrix(n1, n2);
+    vector<vector<uint> > gdvs1, gdvs2;
+    Graph::loadGraphletDegreeVectors(*G1, *G2, gdvs1, gdvs2);
 
+    if (shouldReduce) {
+        for (auto& gdv : gdvs1) gdv = reduce(gdv);
+        for (auto& gdv : gdvs2) gdv = reduce(gdv);
+    }
+    uint dim = gdvs1.empty() ? 0 : gdvs1[0].size();
 
-            if (shouldReduce) {
-                vector<uint> v1 = reduce(gdvs1[i]);
-                vector<uint> v2 = reduce(gdvs2[j]);
+    //magnitudes are computed once per node, and G2's vectors are stored
+    //orbit-major so the dot products with a tile of G2 nodes vectorize.
+    //Products are uint, as they always were.
+    vector<uint> vectors1(n1*dim), vectors2(dim*n2);
+    vector<double> magnitudes1(n1, 0), magnitudes2(n2, 0);
+    for (uint i = 0; i < n1; i++) {
+        for (uint k = 0; k < dim; k++) {
+            vectors1[i*dim+k] = gdvs1[i][k];
+            magnitudes1[i] += gdvs1[i][k] * gdvs1[i][k];
+        }
+        magnitudes1[i] = sqrt(magnitudes1[i]);
+    }
+    for (uint j = 0; j < n2; j++) {
+        for (uint k = 0; k < dim; k++) {
+            vectors2[k*n2+j] = gdvs2[j][k];
+            magnitudes2[j] += gdvs2[j][k] * gdvs2[j][k];
+        }
+        magnitudes2[j] = sqrt(magnitudes2[j]);
+    }
 
-                sims[i][j] = cosineSimilarity(v1, v2);
-            } else {
-                sims[i][j] = cosineSimilarity(gdvs1[i], gdvs2[j]);
+    forEachSimTile([&](uint i, uint jBegin, uint jEnd) {
+        uint tileSize = jEnd - jBegin;
+        double dots[SIM_TILE_COLS] = {0};
+        for (uint k = 0; k < dim; k++) {
+            uint x = vectors1[i*dim+k];
+            const uint* y = &vectors2[k*n2+jBegin];
+            for (uint j = 0; j < tileSize; j++) {
+                dots[j] += x * y[j];
             }
         }
-    }
+        for (uint j = 0; j < tileSize; j++) {
+            sims.writableRow(i)[jBegin+j] = dots[j] / (magnitudes1[i] * magnitudes2[jBegin+j]);
+        }
+    });
 }
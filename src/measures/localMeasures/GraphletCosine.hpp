@@ -9,6 +9,7 @@ public:
 
 private:
     void initSimMatrix();
+    bool isTopological() { return true; }
 
     const uint NUM_ORBITS = 73;
 };
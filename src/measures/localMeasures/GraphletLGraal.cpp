@@ -5,33 +5,48 @@
 using namespace std;
 
 GraphletLGraal::GraphletLGraal(Graph* G1, Graph* G2) : LocalMeasure(G1, G2, "graphletlgraal") {
-    string fileName = autogenMatricesFolder+G1->getName()+"_"+G2->getName()+"_graphletlgraal.bin";
+    string fileName = autogenMatricesFolder+G1->getName()+"_"+G2->getName()+"_graphletlgraal"+
+        to_string((uint) G1->getMaxGraphletSize())+".bin";
     loadBinSimMatrix(fileName);
 }
 
 GraphletLGraal::~GraphletLGraal() {
 }
 
-double GraphletLGraal::gdvSim(uint i, uint j,
-    const vector<vector<uint> >& gdvsG1, const vector<vector<uint> >& gdvsG2) {
-    double total = 0;
-    for (uint k = 0; k < 15; k++) {
-        double m = max(gdvsG1[i][k],gdvsG2[j][k]);
-        if (m > 0) total += min(gdvsG1[i][k],gdvsG2[j][k])/m;
-    }
-    return total/15;
-}
-
 void GraphletLGraal::initSimMatrix() {
     uint n1 = G1->getNumNodes();
     uint n2 = G2->getNumNodes();
-    sims = vector<vector<float> > (n1, vector<float> (n2, 0));
-    vector<vector<uint> > gdvs1 = G1->loadGraphletDegreeVectors();
-    vector<vector<uint> > gdvs2 = G2->loadGraphletDegreeVectors();
+    sims = SimMatrix(n1, n2);
+    vector<vector<uint> > gdvs1, gdvs2;
+    Graph::loadGraphletDegreeVectors(*G1, *G2, gdvs1, gdvs2);
 
+    //G2's counts are stored orbit-major so the loop over a tile of G2 nodes
+    //is contiguous and vectorizes
+    vector<double> counts1(n1*NUM_ORBITS), counts2(NUM_ORBITS*n2);
     for (uint i = 0; i < n1; i++) {
+        for (uint k = 0; k < NUM_ORBITS; k++) {
+            counts1[i*NUM_ORBITS+k] = gdvs1[i][k];
+        }
+    }
+    for (uint k = 0; k < NUM_ORBITS; k++) {
         for (uint j = 0; j < n2; j++) {
-            sims[i][j] = gdvSim(i,j,gdvs1,gdvs2);
+            counts2[k*n2+j] = gdvs2[j][k];
         }
     }
+
+    forEachSimTile([&](uint i, uint jBegin, uint jEnd) {
+        uint tileSize = jEnd - jBegin;
+        double totals[SIM_TILE_COLS] = {0};
+        for (uint k = 0; k < NUM_ORBITS; k++) {
+            double count1 = counts1[i*NUM_ORBITS+k];
+            const double* count2 = &counts2[k*n2+jBegin];
+            for (uint j = 0; j < tileSize; j++) {
+                double m = max(count1, count2[j]);
+                totals[j] += m > 0 ? min(count1, count2[j])/m : 0;
+            }
+        }
+        for (uint j = 0; j < tileSize; j++) {
+            sims.writableRow(i)[jBegin+j] = totals[j]/NUM_ORBITS;
+        }
+    });
 }
@@ -9,10 +9,10 @@ public:
 
 private:
     void initSimMatrix();
-    
-    double gdvSim(uint i, uint j, const vector<vector<uint> >& gdvsG1,
-        const vector<vector<uint> >& gdvsG2);
+    bool isTopological() { return true; }
 
+    //LGRAAL compares the orbits of graphlets of up to 4 nodes only
+    const uint NUM_ORBITS = 15;
 };
 
 #endif
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <climits>
 #include "Importance.hpp"
 
 using namespace std;
@@ -17,66 +18,37 @@ Importance::Importance(Graph* G1, Graph* G2) : LocalMeasure(G1, G2, "importance"
 Importance::~Importance() {
 }
 
-vector<vector<double> > Importance::initEdgeWeights(const Graph& G) {
-    uint n = G.getNumNodes();
-    vector<vector<double> > edgeWeights(n, vector<double> (n, 0));
+Importance::EdgeWeights::EdgeWeights(const Graph& G) {
 #ifdef MULTI_PAIRWISE
     throw runtime_error("Importance not implemented for weighted Graphs");
 #endif
-    Matrix<MATRIX_UNIT> matrix(n);
-    G.getMatrix(matrix);
-    for (uint i = 0; i < n; i++) {
-        for (uint j = 0; j < n; j++) {
-            if (matrix[i][j]) edgeWeights[i][j] = 1;
-        }
-    }
-    return edgeWeights;
-}
-
-struct DegreeComp {
-    DegreeComp(vector<vector<uint> > const *adjLists) {
-        this->adjLists = adjLists;
-    }
-
-    // Note: the paper provides a deterministic algorithm that, unfortunately, means that nodes that "in spirit"
-    // should have the same importance---meaning they have the same degree at some point---will end up with
-    // different importances due to one being deleted before the other.  This is bad because if you simply
-    // reorder the nodes in the input file, you can get a *wildly* different answer.  We probably need to
-    // ameliorate this in some way.  Ideas: easiest is probably to intentionally introduce randomness, compute
-    // "importance" many times based on random shuffles of the node/edge orderings.  Probably a better idea is
-    // to figure out some way to delete all equally-valued importance nodes simultaneously rather than imposing
-    // an arbitrary order.
-    bool operator() (uint i, uint j) {
-        int size1 = (*adjLists)[i].size(), size2 = (*adjLists)[j].size();
-        if (size1 == size2)
-	    return 0;
-	else
-	    return (size1 < size2);
-    }
-
-    vector<vector<uint> > const *adjLists;
-};
-
-vector<uint> Importance::getNodesSortedByDegree(const vector<vector<uint> >& adjLists) {
+    vector<vector<uint> > adjLists;
+    G.getAdjLists(adjLists);
     uint n = adjLists.size();
-    vector<uint> nodes(n);
-    for (uint i = 0; i < n; i++) {
-        nodes[i] = i;
+    offsets = vector<uint>(n+1, 0);
+    for (uint u = 0; u < n; u++) {
+        sort(adjLists[u].begin(), adjLists[u].end());
+        offsets[u+1] = offsets[u] + adjLists[u].size();
     }
-    sort(nodes.begin(), nodes.end(), DegreeComp(&adjLists));
-    vector<uint> res(0);
-    for (uint i = 0; i < n; i++) {
-        if (adjLists[nodes[i]].size() > d) return res;
-        res.push_back(nodes[i]);
+    neighbors = vector<uint>(offsets[n]);
+    edgeIds = vector<uint>(offsets[n]);
+    uint numEdges = 0;
+    for (uint u = 0; u < n; u++) {
+        copy(adjLists[u].begin(), adjLists[u].end(), neighbors.begin() + offsets[u]);
+        for (uint k = offsets[u]; k < offsets[u+1]; k++) {
+            //the smaller endpoint numbers the edge, the larger one finds it
+            uint v = neighbors[k];
+            edgeIds[k] = v > u ? numEdges++ : edgeIds[slot(v, u)];
+        }
     }
-    throw runtime_error("no nodes left");
-    return res;//dummy return
+    weights = vector<double>(numEdges, 1);
 }
 
-void Importance::removeFromAdjList(vector<uint>& list, uint u) {
-    for (uint i = 0; i < list.size(); i++) {
-        if (list[i] == u) list.erase(list.begin()+i);
-    }
+//position of v in the neighbors of u, or UINT_MAX if they are not adjacent
+uint Importance::EdgeWeights::slot(uint u, uint v) const {
+    auto begin = neighbors.begin() + offsets[u], end = neighbors.begin() + offsets[u+1];
+    auto it = lower_bound(begin, end, v);
+    return (it != end and *it == v) ? it - neighbors.begin() : UINT_MAX;
 }
 
 void Importance::normalizeImportances(vector<double>& v) {
@@ -90,50 +62,75 @@ void Importance::normalizeImportances(vector<double>& v) {
     }
 }
 
+/* Nodes are removed in rounds: each round removes every node whose degree
+(in what is left of the graph) is the minimum, as long as that is at most d,
+and all of them spread their weight as they were at the start of the round.
+A node with degree one gives its weight and the weight of its edge to its
+neighbor; a node with a larger degree gives them to the edges between its
+neighbors, evenly. Weight that would go to a node or an edge removed in the
+same round is dropped. Removing equal-degree nodes together makes the result
+independent of the node order, up to rounding. */
 vector<double> Importance::getImportances(const Graph& G) {
     uint n = G.getNumNodes();
 
     vector<double> nodeWeights(n, 0);
-    vector<vector<double> > edgeWeights = initEdgeWeights(G);
+    EdgeWeights edges(G);
 
-    //adjLists will change as we remove nodes from G
-    vector<vector<uint> > adjLists(n);
-    G.getAdjLists(adjLists);
-
-    //as opposed to adjLists, degrees remain true to the original graph
+    //degrees in what is left of the graph
     vector<uint> degrees(n);
-    for (uint i = 0; i < n; i++) degrees[i] = adjLists[i].size();
-
-    vector<uint> nodesSortedByDegree = getNodesSortedByDegree(adjLists); //returns only the nodes with degree <= d
-    for (uint u : nodesSortedByDegree) {
-        //update neighbors' weights
-        if (degrees[u] == 1) {
-            for (uint v : adjLists[u]) {
-                nodeWeights[v] += nodeWeights[u] + edgeWeights[u][v];
+    //round in which each node was removed, UINT_MAX for the nodes left
+    vector<uint> removedIn(n, UINT_MAX);
+    //buckets[k] has the nodes that had degree k when added; entries go stale
+    //when the degree drops further, and are skipped
+    vector<vector<uint> > buckets(d+1);
+    for (uint u = 0; u < n; u++) {
+        degrees[u] = edges.offsets[u+1] - edges.offsets[u];
+        if (degrees[u] <= d) buckets[degrees[u]].push_back(u);
+    }
+    uint numLeft = n;
+    vector<uint> round, present;
+    for (uint r = 0; ; r++) {
+        round.clear();
+        for (uint k = 0; k <= d and round.empty(); k++) {
+            for (uint u : buckets[k]) {
+                if (removedIn[u] == UINT_MAX and degrees[u] == k) round.push_back(u);
             }
+            buckets[k].clear();
         }
-        else {
+        //the last nodes are kept, as with none left every importance would be 0
+        if (round.empty() or round.size() == numLeft) break;
+        sort(round.begin(), round.end());
+        round.erase(unique(round.begin(), round.end()), round.end());
+        for (uint u : round) removedIn[u] = r;
+        numLeft -= round.size();
+
+        for (uint u : round) {
+            //neighbors at the start of the round; only those not in it get weight
+            present.clear();
             double uWeight = nodeWeights[u];
-            for (uint v : adjLists[u]) {
-                uWeight += edgeWeights[u][v];
+            for (uint k = edges.offsets[u]; k < edges.offsets[u+1]; k++) {
+                uint v = edges.neighbors[k];
+                if (removedIn[v] < r) continue;
+                present.push_back(v);
+                uWeight += edges.weights[edges.edgeIds[k]];
             }
-
-            for (uint i = 0; i < adjLists[u].size(); i++) {
-                uint v1 = adjLists[u][i];
-                for (uint j = i+1; j < adjLists[u].size(); j++) {
-                    uint v2 = adjLists[u][j];
-                    double numNeighbors = adjLists[u].size();
-                    edgeWeights[v1][v2] +=
-                        uWeight/((numNeighbors*(numNeighbors-1))/2.0);
+            if (present.size() == 1) {
+                uint v = present[0];
+                if (removedIn[v] == UINT_MAX) nodeWeights[v] += uWeight;
+            } else if (present.size() > 1) {
+                double numNeighbors = present.size();
+                double share = uWeight/((numNeighbors*(numNeighbors-1))/2.0);
+                for (uint i = 0; i < present.size(); i++) {
+                    if (removedIn[present[i]] != UINT_MAX) continue;
+                    for (uint j = i+1; j < present.size(); j++) {
+                        if (removedIn[present[j]] != UINT_MAX) continue;
+                        uint k = edges.slot(present[i], present[j]);
+                        if (k != UINT_MAX) edges.weights[edges.edgeIds[k]] += share;
+                    }
                 }
             }
         }
 
-        for (uint v : adjLists[u]) {
-            removeFromAdjList(adjLists[v], u);
-        }
-
-        nodeWeights[u] = 0;
         /* The paper says: "When one node is removed, its adjacent
         edges are also removed and the weight of the removed node and
         edges are allocated to their neighboring nodes and edges. In this
@@ -143,22 +140,27 @@ vector<double> Importance::getImportances(const Graph& G) {
         The wording seems to indicate so, but then all the nodes with degree <=10 (d)
         would end up with weight 0, and many mappings would be random (this is no longer
         true when also adding sequnece similarity).
-        I assume here that they don't keep their weight (to change this, comment the previous line)
+        I assume here that they don't keep their weight (to change this, do not
+        reset nodeWeights[u] below)
         Note: in a test, the scores were similar in both cases */
 
         /* same story with edge weights... */
-        for (uint i = 0; i < n; i++) {
-            edgeWeights[u][i] = edgeWeights[i][u] = 0;
+        for (uint u : round) {
+            nodeWeights[u] = 0;
+            for (uint k = edges.offsets[u]; k < edges.offsets[u+1]; k++) {
+                edges.weights[edges.edgeIds[k]] = 0;
+                uint v = edges.neighbors[k];
+                if (removedIn[v] == UINT_MAX and --degrees[v] <= d) buckets[degrees[v]].push_back(v);
+            }
         }
     }
 
     //compute importances
-    G.getAdjLists(adjLists); //restore original adjLists
     vector<double> res(n);
     for (uint u = 0; u < n; u++) {
         double edgeWeightSum = 0;
-        for (uint v : adjLists[u]) {
-            edgeWeightSum += edgeWeights[u][v];
+        for (uint k = edges.offsets[u]; k < edges.offsets[u+1]; k++) {
+            edgeWeightSum += edges.weights[edges.edgeIds[k]];
         }
         res[u] = nodeWeights[u] + edgeWeightSum;
     }
@@ -168,48 +170,26 @@ vector<double> Importance::getImportances(const Graph& G) {
 }
 
 void Importance::initSimMatrix() {
-    uint n1 = G1->getNumNodes();
     uint n2 = G2->getNumNodes();
-    sims = vector<vector<float> > (n1, vector<float> (n2, 0));
-
-    vector<vector<uint> > adjListsG1(n1), adjListG1Shuf(n1);
-    vector<vector<uint> > adjListsG2(n2), adjListG2Shuf(n2);
-    G1->getAdjLists(adjListsG1);
-    G2->getAdjLists(adjListsG2);
-#define NUM_SHUFFLES 30
-    cout << "Creating average importances from " << NUM_SHUFFLES << " shuffles of the nodes of G1 and G2\n";
-    for(uint shuf = 0 ; shuf < NUM_SHUFFLES; shuf++)
-    {
-	vector<uint> shuffle1(n1), shuffle2(n2);
-	Graph H1 = G1->randomNodeShuffle(shuffle1);
-	Graph H2 = G2->randomNodeShuffle(shuffle2);
-	H1.getAdjLists(adjListG1Shuf);
-	H2.getAdjLists(adjListG2Shuf);
-	for(uint i=0; i<n1; i++)
-	    assert(adjListsG1[shuffle1[i]].size() == adjListG1Shuf[i].size());
-	for(uint i=0; i<n2; i++)
-	    assert(adjListsG2[shuffle2[i]].size() == adjListG2Shuf[i].size());
-	vector<double> scoresH1 = getImportances(H1);
-	vector<double> scoresH2 = getImportances(H2);
-	for (uint i = 0; i < n1; i++)
-	    for (uint j = 0; j < n2; j++)
-		sims[shuffle1[i]][shuffle2[j]] += min(scoresH1[i],scoresH2[j]);
-    }
-    for (uint i = 0; i < n1; i++)
-	for (uint j = 0; j < n2; j++)
-	    sims[i][j] /= NUM_SHUFFLES;
+    vector<double> scores1 = getImportances(*G1);
+    vector<double> scores2 = getImportances(*G2);
+    sims = SimMatrix(G1->getNumNodes(), n2);
+    forEachSimTile([&](uint i, uint jBegin, uint jEnd) {
+        auto row = sims.writableRow(i);
+        for (uint j = jBegin; j < jEnd; j++) {
+            row[j] = min(scores1[i], scores2[j]);
+        }
+    });
 }
 
 bool Importance::hasNodesWithEnoughDegree(const Graph& G) {
     uint n = G.getNumNodes();
     vector<vector<uint> > adjLists(n);
     G.getAdjLists(adjLists);
-    vector<uint> nodes(n);
     for (uint i = 0; i < n; i++) {
-        nodes[i] = i;
+        if (adjLists[i].size() > d) return true;
     }
-    sort(nodes.begin(), nodes.end(), DegreeComp(&adjLists));
-    return adjLists[nodes[n-1]].size() > d;
+    return false;
 }
 
 bool Importance::fulfillsPrereqs(Graph* G1, Graph* G2) {
@@ -20,12 +20,19 @@ private:
     static const double lambda;
 
     void initSimMatrix();
+    bool isTopological() { return true; }
+
+    //edge weights of a graph, indexed by edge; the edges of node u are
+    //neighbors[offsets[u]..offsets[u+1]), sorted, with ids edgeIds[...]
+    struct EdgeWeights {
+        EdgeWeights(const Graph& G);
+        uint slot(uint u, uint v) const;
+        vector<uint> offsets, neighbors, edgeIds;
+        vector<double> weights;
+    };
 
     static vector<double> getImportances(const Graph& G);
 
-    static vector<vector<double> > initEdgeWeights(const Graph& G);
-    static vector<uint> getNodesSortedByDegree(const vector<vector<uint> >& adjLists);
-    static void removeFromAdjList(vector<uint>& list, uint u);
     static void normalizeImportances(vector<double>& v);
 
     static bool hasNodesWithEnoughDegree(const Graph& G);
@@ -1,10 +1,14 @@
 #include "LocalMeasure.hpp"
+#include "../../utils/ContentCache.hpp"
+#include "../../utils/FlatBinary.hpp"
+#include "../../utils/SimMatrixFile.hpp"
 #include <vector>
 #include <iostream>
 
 using namespace std;
 
 const string LocalMeasure::autogenMatricesFolder = "matrices/autogenerated/";
+uint LocalMeasure::simBits = 32;
 
 LocalMeasure::LocalMeasure(Graph* G1, Graph* G2, string name) : Measure(G1, G2, name) {
 }
@@ -14,6 +18,7 @@ LocalMeasure::~LocalMeasure() {
 
 double LocalMeasure::eval(const Alignment& A) {
     uint n = G1->getNumNodes();
+    const SimMatrix& sims = this->sims;
     double similaritySum = 0;
     for (uint i = 0; i < n; i++) {
         similaritySum += sims[i][A[i]];
@@ -25,46 +30,108 @@ bool LocalMeasure::isLocal() {
     return true;
 }
 
-vector<vector<float> >* LocalMeasure::getSimMatrix() {
+void LocalMeasure::setSimBits(uint bits) {
+    if (bits != 32 and bits != 16 and bits != 8) {
+        throw runtime_error("-simBits must be 32, 16 or 8");
+    }
+    simBits = bits;
+}
+
+uint LocalMeasure::getSimBits() {
+    return simBits;
+}
+
+SimMatrix* LocalMeasure::getSimMatrix() {
     return &sims;
 }
 
+bool LocalMeasure::isTopological() {
+    return false;
+}
+
+static const char SIM_CACHE_MAGIC[8] = {'S','A','N','A','S','I','M','M'};
+static const uint32_t SIM_CACHE_VERSION = 1;
+
+//content cache entry: n1, n2, lo, hi, then one section per row of n2 floats
+static bool loadCachedSimMatrix(const string& cacheFileName, uint n1, uint n2, uint bits, SimMatrix& sims) {
+    if (not FlatBinaryReader::isValid(cacheFileName, SIM_CACHE_MAGIC, SIM_CACHE_VERSION)) return false;
+    FlatBinaryReader in(cacheFileName, SIM_CACHE_MAGIC, SIM_CACHE_VERSION);
+    if (in.readScalar<uint>() != n1 or in.readScalar<uint>() != n2) return false;
+    float lo = in.readScalar<float>();
+    float hi = in.readScalar<float>();
+    SimMatrix m(n1, n2, bits, lo, hi);
+    for (uint i = 0; i < n1; i++) {
+        uint64_t count;
+        const float* row = in.readArray<float>(count);
+        if (count != n2) return false;
+        m.setRow(i, row);
+    }
+    sims = move(m);
+    return true;
+}
+
+//sims must not be quantized yet
+static void storeCachedSimMatrix(const string& cacheFileName, SimMatrix& sims) {
+    ContentCache::store(cacheFileName, [&sims](const string& tmpName) {
+        FlatBinaryWriter out(tmpName, SIM_CACHE_MAGIC, SIM_CACHE_VERSION);
+        float lo, hi;
+        sims.valueRange(lo, hi);
+        out.writeScalar(sims.numRows());
+        out.writeScalar(sims.numCols());
+        out.writeScalar(lo);
+        out.writeScalar(hi);
+        for (uint i = 0; i < sims.numRows(); i++) {
+            out.writeArray(&sims.writableRow(i)[0], sims.numCols());
+        }
+        out.close();
+    });
+}
+
 void LocalMeasure::loadBinSimMatrix(string simMatrixFileName) {
+    string cacheFileName;
+    if (ContentCache::isEnabled() and isTopological()) {
+        //the key has the graph contents and the measure part of the file name
+        //(measure and parameters), not the graph names
+        string prefix = autogenMatricesFolder+G1->getName()+"_"+G2->getName()+"_";
+        string params = simMatrixFileName;
+        if (params.compare(0, prefix.size(), prefix) == 0) params = params.substr(prefix.size());
+        uint64_t key = ContentCache::hash(ContentCache::hash(G1->contentHash(), G2->contentHash()), params);
+        cacheFileName = ContentCache::entryFileName("sim", key);
+        if (loadCachedSimMatrix(cacheFileName, G1->getNumNodes(), G2->getNumNodes(), simBits, sims)) return;
+    }
 #if USE_CACHED_FILES
 // By default, USE_CACHED_FILES is 0 and SANA does not cache files. Change USE_CACHED_FILES at your own risk.
-    if (fileExists(simMatrixFileName)) {
+    if (cacheFileName == "" and fileExists(simMatrixFileName)) {
         uint n1 = G1->getNumNodes();
         uint n2 = G2->getNumNodes();
-        sims = vector<vector<float> > (n1, vector<float> (n2));
-        readMatrixFromBinaryFile(sims, simMatrixFileName);
+        sims = SimMatrix(n1, n2);
+        sims.readFromBinaryFile(simMatrixFileName);
+        sims.quantize(simBits);
         return;
     }
 #endif
-    cout << "Computing " << simMatrixFileName << " ... ";
+    cout << "Computing " << (cacheFileName != "" ? cacheFileName : simMatrixFileName) << " ... ";
     Timer T;
     T.start();
     initSimMatrix();
     cout << "Loading binary sim matrix done (" << T.elapsedString() << ")" << endl;
+    if (cacheFileName != "") {
+        storeCachedSimMatrix(cacheFileName, sims);
+    }
 #if USE_CACHED_FILES
 // By default, USE_CACHED_FILES is 0 and SANA does not cache files. Change USE_CACHED_FILES at your own risk.
-    writeMatrixToBinaryFile(sims, simMatrixFileName);
+    else sims.writeToBinaryFile(simMatrixFileName);
 #endif
+    //measures compute in floats; only the result is stored quantized
+    sims.quantize(simBits);
 }
 
 void LocalMeasure::writeSimsWithNames(string outfile) {
-    unordered_map<uint,string> mapG1 = G1->getIndexToNodeNameMap();
-    unordered_map<uint,string> mapG2 = G2->getIndexToNodeNameMap();
-    uint n1 = G1->getNumNodes();
-    uint n2 = G2->getNumNodes();
-    ofstream fout(outfile);
-    for (uint i = 0; i < n1; i++) {
-        for (uint j = 0; j < n2; j++) {
-            fout << mapG1[i] << " " << mapG2[j] << " " << sims[i][j] << endl;
-        }
-    }
+    SimMatrixFile::write(sims, outfile, SimMatrixFile::NAMES, G1->getNodeNames(), G2->getNodeNames());
 }
 
 double LocalMeasure::balanceWeight(){ //outputs the weight this measure should be multiplied by to scale kind of close to 0 through 1
+    const SimMatrix& sims = this->sims;
     double totalSim = 0;
     uint simNumber = 0;
     for(uint i = 0; i < sims.size(); i++){
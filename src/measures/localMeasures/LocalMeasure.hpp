@@ -1,6 +1,9 @@
 #ifndef LOCALMEASURE_HPP
 #define LOCALMEASURE_HPP
 #include "../Measure.hpp"
+#include "../../utils/SimMatrix.hpp"
+#include <thread>
+#include <atomic>
 
 class LocalMeasure: public Measure {
 public:
@@ -8,17 +11,62 @@ public:
     virtual ~LocalMeasure() =0;
     virtual double eval(const Alignment& A);
     bool isLocal();
-    vector<vector<float> >* getSimMatrix();
+    SimMatrix* getSimMatrix();
     void writeSimsWithNames(string outfile);
     double balanceWeight();
 
+    //bits per entry of the sim matrices of the measures created from now on:
+    //32 (float, the default), or 16 or 8 to store them quantized
+    static void setSimBits(uint bits);
+    static uint getSimBits();
+
 protected:
     void loadBinSimMatrix(string simMatrixFileName);
     virtual void initSimMatrix() =0;
+    //true if sims depends only on the graphs and the parameters in the file
+    //name given to loadBinSimMatrix, so it can go in the content cache
+    virtual bool isTopological();
+
+    //calls kernel(i, jBegin, jEnd) for every row i of sims and every tile of
+    //at most SIM_TILE_COLS columns. Blocks of rows go to all cores, and each
+    //block sweeps the column tiles in order so a tile of per-node G2 data is
+    //reused by every row of the block while it is still in cache.
+    static const uint SIM_TILE_COLS = 256;
+    template <typename F>
+    void forEachSimTile(F kernel);
     
-    vector<vector<float> > sims;
+    SimMatrix sims;
     static const string autogenMatricesFolder;
+    static uint simBits;
 };
 
+template <typename F>
+void LocalMeasure::forEachSimTile(F kernel) {
+    const uint ROW_BLOCK = 16;
+    uint n1 = G1->getNumNodes();
+    uint n2 = G2->getNumNodes();
+    atomic<uint> nextRow(0);
+    auto worker = [&]() {
+        for (uint iBegin = nextRow.fetch_add(ROW_BLOCK); iBegin < n1; iBegin = nextRow.fetch_add(ROW_BLOCK)) {
+            uint iEnd = min(n1, iBegin + ROW_BLOCK);
+            for (uint jBegin = 0; jBegin < n2; jBegin += SIM_TILE_COLS) {
+                uint jEnd = min(n2, jBegin + SIM_TILE_COLS);
+                for (uint i = iBegin; i < iEnd; i++) {
+                    kernel(i, jBegin, jEnd);
+                }
+            }
+        }
+    };
+    uint numThreads = max(1u, thread::hardware_concurrency());
+    vector<thread> threads;
+    for (uint t = 1; t < numThreads; t++) {
+        threads.push_back(thread(worker));
+    }
+    worker();
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
 #endif
 
@@ -16,34 +16,37 @@ NodeCount::NodeCount(Graph* G1, Graph* G2, const vector<double>& distWeights) :
     loadBinSimMatrix(fileName);
 }
 
+//for every node, the number of nodes at distance 1 to h+1, for h < k
+vector<vector<uint> > NodeCount::densities(Graph* G, uint k) {
+    const Graph::NeighborhoodProfiles& P = G->getNeighborhoodProfiles(k);
+    uint n = G->getNumNodes();
+    vector<vector<uint> > res(n, vector<uint> (k));
+    for (uint i = 0; i < n; i++) {
+        uint count = 0;
+        for (uint h = 0; h < k; h++) {
+            count += P.nodesAt(i, h+1);
+            res[i][h] = count;
+        }
+    }
+    return res;
+}
+
 void NodeCount::initSimMatrix() {
     uint n1 = G1->getNumNodes();
     uint n2 = G2->getNumNodes();
     uint k = distWeights.size();
-    vector<vector<uint> > densities1 (n1, vector<uint> (k+1));
-    vector<vector<uint> > densities2 (n2, vector<uint> (k+1));
-    for (uint i = 0; i < n1; i++) {
-        densities1[i] = G1->numNodesAround(i, k);
-        for (uint j = 1; j < k; j++) {
-            densities1[i][j] += densities1[i][j-1];
-        } 
-    }
-    for (uint i = 0; i < n2; i++) {
-        densities2[i] = G2->numNodesAround(i, k);
-        for (uint j = 1; j < k; j++) {
-            densities2[i][j] += densities2[i][j-1];
-        }
-    }
-    sims = vector<vector<float> > (n1, vector<float> (n2, 0));
+    vector<vector<uint> > densities1 = densities(G1, k);
+    vector<vector<uint> > densities2 = densities(G2, k);
+    sims = SimMatrix(n1, n2);
     for (uint h = 0; h < k; h++) {
         if (distWeights[h] > 0) {
             for (uint i = 0; i < n1; i++) {
                 for (uint j = 0; j < n2; j++) {
                     if (densities1[i][h] < densities2[j][h]) {
-                        sims[i][j] += ((double) densities1[i][h]/densities2[j][h]) * distWeights[h];
+                        sims.writableRow(i)[j] += ((double) densities1[i][h]/densities2[j][h]) * distWeights[h];
                     }
                     else {
-                        sims[i][j] += ((double) densities2[j][h]/densities1[i][h]) * distWeights[h];
+                        sims.writableRow(i)[j] += ((double) densities2[j][h]/densities1[i][h]) * distWeights[h];
                     }
                 }
             }
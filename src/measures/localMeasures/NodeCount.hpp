@@ -10,6 +10,8 @@ private:
     vector<double> distWeights;
     
     void initSimMatrix();
+    vector<vector<uint> > densities(Graph* G, uint k);
+    bool isTopological() { return true; }
 };
 
 #endif
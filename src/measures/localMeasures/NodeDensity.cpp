@@ -1,53 +1,26 @@
 #include "NodeDensity.hpp"
 
 #include <vector>
-#include <queue>
 #include <iostream>
 
 using namespace std;
 
 NodeDensity::NodeDensity(Graph* G1, Graph* G2, uint maxDist) : LocalMeasure(G1, G2, "noded") {
     string fileName = autogenMatricesFolder+G1->getName()+"_"+
-        G2->getName()+"_noded";
+        G2->getName()+"_noded_"+to_string(maxDist);
     fileName += ".bin";
     this->maxDist = maxDist;
 
     loadBinSimMatrix(fileName);
 }
 
-double NodeDensity::calcNodeDensity (vector<vector<uint> > adjList, uint originNode, uint numNodes, uint maxDist) {
-    uint UNINTIALIZED_DISTANCE = numNodes;
-    vector<uint> distanceFromOrigin(numNodes,UNINTIALIZED_DISTANCE);
-    queue <uint> Q;
-
-    uint numNodesWithinMaxDistance = 0;
-    distanceFromOrigin[originNode] = 0;
-    Q.push(originNode);
-
-    while(not Q.empty()) {
-        uint currentNode = Q.front();
-        Q.pop();
-        uint dist = distanceFromOrigin[currentNode];
-        if(dist == maxDist) break;
-        numNodesWithinMaxDistance++;
-
-        for(uint neighbor : adjList[currentNode]) {
-            if(distanceFromOrigin[neighbor] == UNINTIALIZED_DISTANCE) {
-                distanceFromOrigin[neighbor] = dist + 1;
-                Q.push(neighbor);
-            }
-        }
-    }
-
-    return numNodesWithinMaxDistance/(double)numNodes;
-}
-
+//fraction of the nodes at distance less than maxDist of each node
 vector<double> NodeDensity::generateVector(Graph* g, uint maxDist) {
-    vector<vector<uint> > adjList;
-    g->getAdjLists(adjList);
-    vector<double> noded(g->getNumNodes());
-    for(uint i = 0; i < g->getNumNodes(); ++i) {
-        noded[i] = calcNodeDensity(adjList, i, g->getNumNodes(), maxDist);
+    uint n = g->getNumNodes();
+    vector<double> noded(n, 0);
+    const Graph::NeighborhoodProfiles& P = g->getNeighborhoodProfiles(maxDist > 0 ? maxDist-1 : 0);
+    for (uint i = 0; i < n; ++i) {
+        if (maxDist > 0) noded[i] = P.nodesWithin(i, maxDist-1)/(double)n;
     }
     return noded;
 }
@@ -68,10 +41,10 @@ void NodeDensity::initSimMatrix() {
     uint size1 = noded1.size();
     uint size2 = noded2.size();
 
-    sims = vector<vector<float> > (size1, vector<float> (size2, 0));
+    sims = SimMatrix(size1, size2);
     for(uint i = 0; i < size1;  ++i) {
         for(uint j = 0; j < size2;  ++j) {
-            sims[i][j] = compare(noded1[i], noded2[j]);
+            sims.writableRow(i)[j] = compare(noded1[i], noded2[j]);
         }
     }
 }
@@ -8,8 +8,8 @@ public:
     virtual ~NodeDensity();
 private:
     void initSimMatrix();
+    bool isTopological() { return true; }
     float compare(double n1, double n2);
-    double calcNodeDensity(vector<vector<uint> > adjList, uint originNode, uint numNodes, uint maxDist);
     vector<double> generateVector(Graph* g, uint maxDist);
     vector<double> noded1;
     vector<double> noded2;
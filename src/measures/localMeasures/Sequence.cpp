@@ -65,7 +65,7 @@ void Sequence::initSimMatrix() {
 
     uint n1 = G1->getNumNodes();
     uint n2 = G2->getNumNodes();
-    sims = vector<vector<float> > (n1, vector<float> (n2, 0));
+    sims = SimMatrix(n1, n2);
 
     unordered_map<string,uint> g1NodeToIndexMap = G1->getNodeNameToIndexMap();
     unordered_map<string,uint> g2NodeToIndexMap = G2->getNodeNameToIndexMap();
@@ -94,14 +94,14 @@ void Sequence::initSimMatrix() {
         //assert(sims[index1][index2] == 0); //there ARE many repeated entries, not sure why
         //keep the maximum among all repeated entries
         //this is a rather arbitrary decision...
-        sims[index1][index2] = max(sims[index1][index2], stof(bitscore));
+        sims.writableRow(index1)[index2] = max(sims[index1][index2], stof(bitscore));
         if (sims[index1][index2] > maxim) maxim = sims[index1][index2];
     }
 
     //normalize
     for (uint i = 0; i < n1; i++) {
         for (uint j = 0; j < n2; j++) {
-            sims[i][j] /= maxim;
+            sims.writableRow(i)[j] /= maxim;
         }
     }
 }
@@ -30,7 +30,7 @@ Dijkstra::Dijkstra(Graph* G1, Graph* G2, MeasureCombination* MC, double d) :
 
   A = vector<uint> (n1);
 
-  sims = MC->getAggregatedLocalSims();
+  sims = &MC->getAggregatedLocalSims();
 
   make_seed_queue();
 }
@@ -51,9 +51,9 @@ void Dijkstra::make_seed_queue(){
   std::cout << "make seed queue begin" << std::endl;
   auto start = get_time::now();
 
- for(unsigned int i = 0; i < sims.size(); ++i){
-    for(unsigned int j = 0; j < sims[i].size(); ++j){
-      seed_queue.insert(sims[i][j], std::make_pair(i,j));
+ for(unsigned int i = 0; i < sims->size(); ++i){
+    for(unsigned int j = 0; j < (*sims)[i].size(); ++j){
+      seed_queue.insert((*sims)[i][j], std::make_pair(i,j));
     }
   }
 
@@ -118,15 +118,15 @@ void Dijkstra::best_neighbors(std::pair <uint, uint> & seed_pair, vector<uint> &
     }
   */
   float max_sim = -1;
-  float seed_sim = sims[seed_pair.first][seed_pair.second];
+  float seed_sim = (*sims)[seed_pair.first][seed_pair.second];
   double seed_w = 0.5;
   double node_w = 1 - seed_w;
   for(unsigned int i = 0; i < G1_neighbors.size(); ++i){
     for(unsigned int j = 0; j < G2_neighbors.size(); ++j){
       //small_matrix[i][j] = sims[G1_neighbors[i]] [G2_neighbors[j]];
-      small_matrix[i][j] = sims[G1_neighbors[i]] [G2_neighbors[j]] * node_w + seed_sim * seed_w;
+      small_matrix[i][j] = (*sims)[G1_neighbors[i]] [G2_neighbors[j]] * node_w + seed_sim * seed_w;
       if(small_matrix[i][j] > max_sim){
-    max_sim = sims[G1_neighbors[i]] [G2_neighbors[j]];
+    max_sim = (*sims)[G1_neighbors[i]] [G2_neighbors[j]];
       }
     }
   }
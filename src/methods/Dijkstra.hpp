@@ -48,7 +48,7 @@ private:
 
   vector<uint> A;
 
-  vector<vector<float> > sims;
+  const SimMatrix* sims; //owned by MC
 
   bool implementsLocking(){ return false; }
     
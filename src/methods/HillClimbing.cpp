@@ -104,26 +104,27 @@ Alignment HillClimbing::run() {
     else g2InducedEdges = 1; //dummy value
 
     //initialize data structures for incremental evaluation of local measures
-    vector<vector<float> > localsCombined (n1, vector<float> (n2, 0));
+    SimMatrix combined(n1, n2);
     for (uint i = 0; i < M->numMeasures(); i++) {
         Measure* m = M->getMeasure(i);
         float weight = M->getWeight(m->getName());
         if (m->isLocal() and weight > 0) {
-            vector<vector<float> >* simMatrix = ((LocalMeasure*) m)->getSimMatrix();
+            const SimMatrix* simMatrix = ((LocalMeasure*) m)->getSimMatrix();
             for (uint i = 0; i < n1; i++) {
                 for (uint j = 0; j < n2; j++) {
-                    localsCombined[i][j] += weight * (*simMatrix)[i][j];
+                    combined.writableRow(i)[j] += weight * (*simMatrix)[i][j];
                 }
             }
         }
     }
-    Measure* allLocals = new GenericLocalMeasure(G1, G2, "locals", localsCombined);
+    LocalMeasure* allLocals = new GenericLocalMeasure(G1, G2, "locals", move(combined));
+    const SimMatrix& localsCombined = *allLocals->getSimMatrix();
     double localScoreSum = allLocals->eval(Alignment(A)) * n1;
 
     //initialize data structures for incremental evaluation of WEC
     double wecWeight = M->getWeight("wec");
     double wecSum = 0;
-    vector<vector<float> >* wecSimMatrix = NULL;
+    const SimMatrix* wecSimMatrix = NULL;
     if (wecWeight > 0) {
         WeightedEdgeConservation* wec = (WeightedEdgeConservation*) M->getMeasure("wec");
         wecSum = wec->eval(Alignment(A))*2*g1Edges;
@@ -0,0 +1,135 @@
+#include <cmath>
+#include <thread>
+#include <iostream>
+#include "ParallelTempering.hpp"
+#include "../utils/Timer.hpp"
+#include "../utils/randomSeed.hpp"
+
+using namespace std;
+
+ParallelTempering::ParallelTempering(Graph* G1, Graph* G2, SANA* sana, MeasureCombination* MC,
+        double minutes, uint numReplicas, long long int exchangeIterations):
+    Method(G1, G2, "ParallelTempering_"+MC->toString()), sana(sana), MC(MC), minutes(minutes),
+    numReplicas(numReplicas), exchangeIterations(exchangeIterations)
+{
+    if (numReplicas < 2) {
+        throw runtime_error("parallel tempering needs at least 2 replicas");
+    }
+    if (exchangeIterations <= 0) {
+        throw runtime_error("-exchangeiterations must be positive");
+    }
+}
+
+ParallelTempering::~ParallelTempering() {
+    delete sana;
+}
+
+void ParallelTempering::initTemperatures() {
+    double log10Low = 0, log10High = 0;
+    sana->findingUpperLowerTemperatureBound(log10Low, log10High);
+    cout << "Replica temperatures span 1E" << log10Low << " to 1E" << log10High << endl;
+
+    temperatures = vector<double> (numReplicas);
+    for (uint i = 0; i < numReplicas; i++) {
+        double logT = log10Low + i*(log10High-log10Low)/(numReplicas-1);
+        temperatures[i] = pow(10, logT);
+    }
+}
+
+void ParallelTempering::runReplica(SANA* replica, double temperature, long long int iterations) {
+    replica->Temperature = temperature;
+    for (long long int i = 0; i < iterations; i++) {
+        replica->SANAIteration();
+    }
+}
+
+Alignment ParallelTempering::run() {
+    initTemperatures();
+    exchangeAttempts = vector<uint> (numReplicas-1, 0);
+    exchangeAccepts  = vector<uint> (numReplicas-1, 0);
+
+    //replica i starts at temperature i; replicaAt[t] is the replica currently at temperature t
+    vector<SANA*> replicas(numReplicas, sana);
+    vector<uint> replicaAt(numReplicas);
+    for (uint i = 0; i < numReplicas; i++) {
+        if (i > 0) replicas[i] = new SANA(*sana);
+        replicas[i]->chainId = i;
+        replicas[i]->gen = mt19937(getRandomSeed() + i);
+        replicas[i]->initDataStructures(sana->getStartingAlignment());
+        replicaAt[i] = i;
+    }
+    mt19937 gen(getRandomSeed() + numReplicas);
+    uniform_real_distribution<> randomReal(0, 1);
+
+    Alignment best(*(replicas[0]->A));
+    double bestScore = replicas[0]->currentScore;
+
+    Timer T;
+    T.start();
+    sana->setInterruptSignal();
+    while (T.elapsed() < minutes*60 and not interrupt) {
+        vector<thread> threads;
+        for (uint t = 0; t < numReplicas; t++) {
+            threads.push_back(thread(runReplica, replicas[replicaAt[t]], temperatures[t], exchangeIterations));
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+
+        for (uint t = 0; t < numReplicas; t++) {
+            SANA* r = replicas[replicaAt[t]];
+            if (r->currentScore > bestScore) {
+                bestScore = r->currentScore;
+                best = Alignment(*(r->A));
+            }
+        }
+
+        //alternate between even and odd pairs so every pair is tried every other round
+        for (uint t = rounds % 2; t+1 < numReplicas; t += 2) {
+            double scoreCold = replicas[replicaAt[t]]->currentScore;
+            double scoreHot  = replicas[replicaAt[t+1]]->currentScore;
+            double delta = (scoreHot - scoreCold) * (1/temperatures[t] - 1/temperatures[t+1]);
+            exchangeAttempts[t]++;
+            if (delta >= 0 or randomReal(gen) < exp(delta)) {
+                swap(replicaAt[t], replicaAt[t+1]);
+                exchangeAccepts[t]++;
+            }
+        }
+        rounds++;
+
+        if (rounds % 10 == 0) {
+            cout << rounds << " (" << T.elapsed() << "s): best = " << bestScore << ", by temperature:";
+            for (uint t = 0; t < numReplicas; t++) {
+                cout << " " << replicas[replicaAt[t]]->currentScore;
+            }
+            cout << endl;
+        }
+    }
+
+    for (uint i = 1; i < numReplicas; i++) {
+        delete replicas[i];
+    }
+    cout << "Best incremental score " << bestScore << ", evaluated " << MC->eval(best) << endl;
+    return best;
+}
+
+void ParallelTempering::describeParameters(ostream& stream) {
+    stream << "Replicas: " << numReplicas << endl;
+    stream << "Iterations between exchanges: " << exchangeIterations << endl;
+    stream << "Exchange rounds: " << rounds << endl;
+    stream << "Optimize: " << endl;
+    MC->printWeights(stream);
+    stream << "Execution time: " << minutes << "m" << endl;
+    stream << "Temperatures (exchange acceptance with the next one):" << endl;
+    for (uint t = 0; t < temperatures.size(); t++) {
+        stream << "- " << temperatures[t];
+        if (t+1 < temperatures.size() and exchangeAttempts[t] > 0) {
+            stream << " (" << (double) exchangeAccepts[t]/exchangeAttempts[t] << ")";
+        }
+        stream << endl;
+    }
+}
+
+string ParallelTempering::fileNameSuffix(const Alignment& A) {
+    return "_" + extractDecimals(MC->eval(A),3);
+}
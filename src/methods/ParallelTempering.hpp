@@ -0,0 +1,45 @@
+#ifndef PARALLELTEMPERING_HPP
+#define PARALLELTEMPERING_HPP
+#include <vector>
+#include <random>
+#include "Method.hpp"
+#include "SANA.hpp"
+#include "../measures/MeasureCombination.hpp"
+
+/*
+Replica exchange (parallel tempering) on top of SANA's incremental evaluators.
+K replicas, one per thread, each run SANA moves at a fixed temperature. The
+temperatures are spaced geometrically between the bounds of the region where
+pBad goes from ~0 to ~1, so no temperature decay has to be estimated.
+Every exchangeIterations iterations neighboring replicas try to swap
+temperatures with the usual Metropolis criterion, letting good alignments
+found at high temperature sink to the cold end.
+*/
+class ParallelTempering: public Method {
+public:
+    //sana is owned (and deleted) by this object
+    ParallelTempering(Graph* G1, Graph* G2, SANA* sana, MeasureCombination* MC,
+        double minutes, uint numReplicas, long long int exchangeIterations);
+    ~ParallelTempering();
+
+    Alignment run();
+    void describeParameters(ostream& stream);
+    string fileNameSuffix(const Alignment& A);
+
+private:
+    SANA* sana;
+    MeasureCombination* MC;
+    double minutes;
+    uint numReplicas;
+    long long int exchangeIterations;
+
+    vector<double> temperatures; //sorted from coldest to hottest
+    vector<uint> exchangeAttempts; //per pair of neighboring temperatures
+    vector<uint> exchangeAccepts;
+    uint rounds = 0;
+
+    void initTemperatures();
+    static void runReplica(SANA* replica, double temperature, long long int iterations);
+};
+
+#endif
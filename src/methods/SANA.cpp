@@ -17,6 +17,7 @@
 #include <limits>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <cassert>
 #include <signal.h>
 #include <stdio.h>
@@ -29,6 +30,8 @@
 #include "../measures/SquaredEdgeScore.hpp"
 #include "../measures/WeightedEdgeConservation.hpp"
 #include "../measures/TriangleCorrectness.hpp"
+#include "../measures/ShortestPathConservation.hpp"
+#include "../measures/LargestCommonConnectedSubgraph.hpp"
 #include "../measures/NodeCorrectness.hpp"
 #include "../measures/SymmetricEdgeCoverage.hpp"
 #include "../measures/localMeasures/Sequence.hpp"
@@ -41,6 +44,27 @@
 
 using namespace std;
 
+//The similarity matrices are read in place from the measures that computed
+//them (they are too big to copy for large networks); the ones SANA does not
+//need are bound to an empty matrix.
+static const SimMatrix emptySimMatrix;
+
+static const SimMatrix& wecSimMatrix(MeasureCombination* MC) {
+    try {
+        if (MC->getWeight("wec") > 0) {
+            Measure* wec = MC->getMeasure("wec");
+            return *((WeightedEdgeConservation*) wec)->getNodeSimMeasure()->getSimMatrix();
+        }
+    } catch (...) {
+    }
+    return emptySimMatrix;
+}
+
+static const SimMatrix& localSimMatrix(MeasureCombination* MC) {
+    if (MC->getSumLocalWeight() > 0) return MC->getAggregatedLocalSims();
+    return emptySimMatrix;
+}
+
 void SANA::initTau(void) {
     /*
     tau = vector<double> {
@@ -74,7 +98,13 @@ SANA::SANA(Graph* G1, Graph* G2,
 #ifdef MULTI_PAIRWISE
         ,string& startAligName
 #endif
-        ): Method(G1, G2, "SANA_"+MC->toString())
+        ): Method(G1, G2, "SANA_"+MC->toString()),
+        shared(new SharedData),
+        G1Matrix(shared->G1Matrix), G2Matrix(shared->G2Matrix),
+        G1AdjLists(shared->G1AdjLists), G2AdjLists(shared->G2AdjLists),
+        G1TriangleLists(shared->G1TriangleLists),
+        wecSims(wecSimMatrix(MC)), sims(localSimMatrix(MC)),
+        getJobMutex(shared->jobMutex)
 {
     //data structures for the networks
     n1              = G1->getNumNodes();
@@ -205,6 +235,24 @@ SANA::SANA(Graph* G1, Graph* G2,
         TCWeight = 0;
     }
 
+    try {
+        spcWeight = MC->getWeight("spc");
+    } catch (...) {
+        spcWeight = 0;
+    }
+    if (spcWeight > 0 and score != Score::sum) {
+        throw runtime_error("spc can only be optimized with the sum objective score");
+    }
+
+    try {
+        lccsnWeight = MC->getWeight("lccsn");
+    } catch (...) {
+        lccsnWeight = 0;
+    }
+    if (lccsnWeight > 0 and score != Score::sum) {
+        throw runtime_error("lccsn can only be optimized with the sum objective score");
+    }
+
     localWeight = MC->getSumLocalWeight();
 
 
@@ -217,14 +265,15 @@ SANA::SANA(Graph* G1, Graph* G2,
     needEwec             = ewecWeight>0; //to evaluate EWEC incrementally
     needSec              = secWeight > 0; //to evaluate SEC incrementally
     needTC               = TCWeight > 0; //to evaluation TC incrementally
+    needSpc              = spcWeight > 0; //to evaluate SPC incrementally
+    needLccs             = lccsnWeight > 0; //to evaluate LCCSN incrementally
     needLocal            = localWeight > 0;
+    fuseEdgeIncs         = (needAligEdges or needSec) and (needSquaredAligEdges or needWec);
 
-    if (needWec) {
-        Measure* wec                     = MC->getMeasure("wec");
-        LocalMeasure* m                  = ((WeightedEdgeConservation*) wec)->getNodeSimMeasure();
-        vector<vector<float> >* wecSimsP = m->getSimMatrix();
-        wecSims                          = (*wecSimsP);
+    if (needTC) {
+        initG1TriangleLists();
     }
+
 #ifdef CORES
     coreFreq = Matrix<ulong>(n1, n2);
     coreCount       = vector<ulong>(n1, 0);
@@ -233,9 +282,7 @@ SANA::SANA(Graph* G1, Graph* G2,
 #endif
     //to evaluate local measures incrementally
     if (needLocal) {
-        sims              = MC->getAggregatedLocalSims();
-        localSimMatrixMap = MC->getLocalSimMap();
-        localWeight       = 1; //the values in the sim matrix 'sims' have already been scaled by the weight
+        localWeight = 1; //the values in the sim matrix 'sims' have already been scaled by the weight
     } else {
         localWeight = 0;
     }
@@ -296,7 +343,15 @@ Alignment SANA::run() {
     else {
         long long int iter = 0;
         Alignment align;
-        if(!usingIterations) {
+        if (numThreads > 1 and not measuresAreThreadSafe()) {
+            //every chain evaluates its alignment in trackProgress
+            cout << "Some measures are not thread safe, running a single chain" << endl;
+            numThreads = 1;
+        }
+        if (numThreads > 1) {
+            align = runIndependentChains();
+        }
+        else if(!usingIterations) {
           cout << "usingIterations = 0" << endl;
           align = simpleRun(getStartingAlignment(), minutes * 60 * 5, (long long int) (getIterPerSecond()*minutes*60), iter);
         }
@@ -481,6 +536,17 @@ void SANA::describeParameters(ostream& sout) {
         sout << "number new alignments: " << newAlignmentsCount << endl;
         sout << "iterations per new alignment: " << iterationsPerStep << endl;
     }
+
+    sout << "Iteration kernel: " << iterationKernelName << endl;
+
+    if (numThreads > 1) {
+        sout << "Independent chains: " << numThreads << endl;
+        for (uint i = 0; i < chainSeeds.size(); i++) {
+            sout << "- chain " << i << ": seed " << chainSeeds[i] << ", score " << chainScores[i];
+            if (i == bestChain) sout << " (best)";
+            sout << endl;
+        }
+    }
 }
 
 string SANA::fileNameSuffix(const Alignment& A) {
@@ -501,6 +567,70 @@ void SANA::enableRestartScheme(double minutesNewAlignments, uint iterationsPerSt
     }
 }
 
+void SANA::setNumThreads(uint numThreads) {
+    this->numThreads = numThreads > 0 ? numThreads : 1;
+}
+
+bool SANA::measuresAreThreadSafe() {
+    //MC->eval only evaluates the measures with a weight
+    for (uint i = 0; i < MC->numMeasures(); i++) {
+        Measure* m = MC->getMeasure(i);
+        if (MC->getWeight(m->getName()) > 0 and not m->isThreadSafe()) return false;
+    }
+    return true;
+}
+
+Alignment SANA::runIndependentChains() {
+    //everything that is not thread safe (the global RNG used to build random
+    //alignments, the iteration speed calibration) is done here, before the
+    //chains are copied from this object
+    long long int maxExecutionIterations = usingIterations ?
+        ((long long int)(maxIterations))*10000000 : (long long int) (getIterPerSecond()*minutes*60);
+
+    vector<Alignment> startAligs;
+    chainSeeds = vector<uint> (numThreads);
+    for (uint i = 0; i < numThreads; i++) {
+        startAligs.push_back(getStartingAlignment());
+        chainSeeds[i] = getRandomSeed() + i;
+    }
+    cout << "Running " << numThreads << " independent SANA chains" << endl;
+
+    //chain 0 is this object; the rest are copies that share the read-only data
+    vector<SANA*> chains(numThreads, this);
+    for (uint i = 1; i < numThreads; i++) {
+        chains[i] = new SANA(*this);
+        chains[i]->chainId = i;
+    }
+    vector<Alignment> results(numThreads);
+    vector<thread> threads;
+    for (uint i = 0; i < numThreads; i++) {
+        threads.push_back(thread([this, &chains, &startAligs, &results, maxExecutionIterations, i]() {
+            SANA* chain = chains[i];
+            chain->gen = mt19937(chainSeeds[i]);
+            long long int iter = 0;
+            if (usingIterations)
+                results[i] = chain->simpleRun(startAligs[i], maxExecutionIterations, iter);
+            else
+                results[i] = chain->simpleRun(startAligs[i], minutes * 60 * 5, maxExecutionIterations, iter);
+        }));
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    chainScores = vector<double> (numThreads);
+    bestChain = 0;
+    for (uint i = 0; i < numThreads; i++) {
+        chainScores[i] = eval(results[i]);
+        cout << "chain " << i << " (seed " << chainSeeds[i] << "): score = " << chainScores[i] << endl;
+        if (chainScores[i] > chainScores[bestChain]) bestChain = i;
+    }
+    for (uint i = 1; i < numThreads; i++) {
+        delete chains[i];
+    }
+    return results[bestChain];
+}
+
 double SANA::temperatureFunction(long long int iter, double TInitial, double TDecay) {
     double fraction;
     if(usingIterations)
@@ -571,11 +701,18 @@ void SANA::initDataStructures(const Alignment& startA) {
     }
 
     if (needLocal) {
-        localScoreSum = 0;
-        for (uint i = 0; i < n1; i++) {
-            localScoreSum += sims[i][(*A)[i]];
+        sumLocalScores();
+
+        //the score uses the aggregated sims and eval() the sims of each measure,
+        //so with quantized sims they can differ by half a step of each of them
+        localQuantizationError = sims.quantizationStep() / 2;
+        for (uint i = 0; i < MC->numMeasures(); i++) {
+            Measure* m = MC->getMeasure(i);
+            if (m->isLocal()) {
+                double step = ((LocalMeasure*) m)->getSimMatrix()->quantizationStep();
+                localQuantizationError += MC->getWeight(m->getName()) * step / 2;
+            }
         }
-        localScoreSumMap = new map<string, double>;
     }
 
     if (needWec) {
@@ -600,10 +737,24 @@ void SANA::initDataStructures(const Alignment& startA) {
         TCSum        = tc->eval(*A);
     }
 
+    if (needSpc) {
+        spc    = (ShortestPathConservation*) MC->getMeasure("spc");
+        spcSum = spc->distanceDifferenceSum(startA);
+    }
+
+    if (needLccs) {
+        //the tracker holds the state of this alignment, so copies of this
+        //object (independent chains, parallel tempering replicas) cannot share it
+        lccs     = make_shared<LargestCommonConnectedSubgraph>(G1, G2, false);
+        lccs->initIncremental(startA.getMapping());
+        lccsSize = lccs->largestSize();
+    }
+
     iterationsPerformed = 0;
     sampledProbability.clear();
 
     currentScore = eval(startA);
+    selectIterationKernel();
     timer.start();
 }
 
@@ -702,6 +853,7 @@ unordered_set<vector<uint>*>* SANA::simpleParetoRun(const Alignment& startA, dou
     paretoFront = ParetoFront(paretoCapacity, numOfMeasures, measureNames);
     assert(numOfMeasures > 1 && "Pareto mode must optimize on more than one measure");
     score = Score::pareto;
+    selectIterationKernel();
     initializeParetoFront();
 
     for (; ; ++iter) {
@@ -737,6 +889,7 @@ unordered_set<vector<uint>*>* SANA::simpleParetoRun(const Alignment& startA, lon
     paretoFront = ParetoFront(paretoCapacity, numOfMeasures, measureNames);
     assert(numOfMeasures > 1 && "Pareto mode must optimize on more than one measure");
     score = Score::pareto;
+    selectIterationKernel();
     initializeParetoFront();
 
     for (; ; ++iter) {
@@ -883,7 +1036,6 @@ void SANA::prepareMeasureDataByAlignment() {
     inducedEdges     = (needInducedEdges) ?  storedInducedEdges[A] : -1;
     TCSum            = (needTC) ?  storedTCSum[A] : -1;
     localScoreSum    = (needLocal) ? storedLocalScoreSum[A] : -1;
-    localScoreSumMap = (needLocal) ? new map<string, double>(*storedLocalScoreSumMap[A]) : nullptr;
     wecSum           = (needWec) ?  storedWecSum[A] : -1;
     ewecSum          = (needEwec) ?  storedEwecSum[A] : -1;
     ncSum            = (needNC) ? storedNcSum[A] : -1;
@@ -909,8 +1061,6 @@ void SANA::releaseAlignment() {
     delete unassignedNodesG2;
     delete unassignedmiRNAsG2;
     delete unassignedgenesG2;
-    if (needLocal) 
-        delete localScoreSumMap;
 }
 
 void SANA::insertCurrentAndPrepareNewMeasureDataByAlignment(vector<double> &addScores) {
@@ -948,7 +1098,6 @@ void SANA::insertCurrentAlignmentAndData() {
     if(needInducedEdges)         storedInducedEdges[A]     = inducedEdges;
     if(needTC)                   storedTCSum[A]            = TCSum;
     if(needLocal)                storedLocalScoreSum[A]    = localScoreSum;
-    if(needLocal)                storedLocalScoreSumMap[A] = localScoreSumMap;
     if(needWec)                  storedWecSum[A]           = wecSum;
     if(needEwec)                 storedEwecSum[A]          = ewecSum;
     if(needNC)                   storedNcSum[A]            = ncSum;
@@ -980,7 +1129,6 @@ void SANA::removeAlignmentData(vector<uint>* toRemove) {
     if(needInducedEdges)         storedInducedEdges.erase(toRemove);
     if(needTC)                   storedTCSum.erase(toRemove);
     if(needLocal)                storedLocalScoreSum.erase(toRemove);
-    if(needLocal)                storedLocalScoreSumMap.erase(toRemove);
     if(needWec)                  storedWecSum.erase(toRemove);
     if(needEwec)                 storedEwecSum.erase(toRemove);
     if(needNC)                   storedNcSum.erase(toRemove);
@@ -1033,11 +1181,143 @@ void SANA::deallocateParetoData() {
         for(auto i = storedUnassignedgenesG2.begin(); i != storedUnassignedgenesG2.end(); i++)
             delete i->second;
     }
-    for(auto i = storedLocalScoreSumMap.begin(); i != storedLocalScoreSumMap.end(); i++)
-        delete i->second;
 }
 
 void SANA::SANAIteration() {
+    (this->*iterationKernel)();
+}
+
+void SANA::selectIterationKernel() {
+    iterationKernel     = &SANA::genericSANAIteration;
+    iterationKernelName = "generic";
+#ifndef CORES
+    if (score != Score::sum or nodesHaveType) return;
+    if (icsWeight > 0 or secWeight > 0 or mecWeight > 0 or wecWeight > 0 or ewecWeight > 0
+            or TCWeight > 0 or ncWeight > 0 or spcWeight > 0 or lccsnWeight > 0) return;
+
+    uint measures = 0;
+    if (ecWeight > 0)    measures |= kernelEC;
+    if (s3Weight > 0)    measures |= kernelS3;
+    if (localWeight > 0) measures |= kernelLocal;
+#ifdef MULTI_PAIRWISE
+    if (sesWeight > 0)   measures |= kernelSES;
+#endif
+
+    switch (measures) {
+    case kernelEC:
+        iterationKernel = &SANA::kernelSANAIteration<kernelEC>;
+        iterationKernelName = "ec"; break;
+    case kernelS3:
+        iterationKernel = &SANA::kernelSANAIteration<kernelS3>;
+        iterationKernelName = "s3"; break;
+    case kernelEC | kernelS3:
+        iterationKernel = &SANA::kernelSANAIteration<kernelEC | kernelS3>;
+        iterationKernelName = "ec+s3"; break;
+    case kernelLocal:
+        iterationKernel = &SANA::kernelSANAIteration<kernelLocal>;
+        iterationKernelName = "local"; break;
+    case kernelEC | kernelLocal:
+        iterationKernel = &SANA::kernelSANAIteration<kernelEC | kernelLocal>;
+        iterationKernelName = "ec+local"; break;
+    case kernelS3 | kernelLocal:
+        iterationKernel = &SANA::kernelSANAIteration<kernelS3 | kernelLocal>;
+        iterationKernelName = "s3+local"; break;
+    case kernelEC | kernelS3 | kernelLocal:
+        iterationKernel = &SANA::kernelSANAIteration<kernelEC | kernelS3 | kernelLocal>;
+        iterationKernelName = "ec+s3+local"; break;
+    case kernelSES:
+        iterationKernel = &SANA::kernelSANAIteration<kernelSES>;
+        iterationKernelName = "ses"; break;
+    default:
+        break;
+    }
+#endif
+}
+
+template <uint measures>
+void SANA::kernelSANAIteration() {
+    ++iterationsPerformed;
+    (randomReal(gen) < changeProbability[0]) ? kernelPerformChange<measures>() : kernelPerformSwap<measures>();
+}
+
+template <uint measures>
+void SANA::kernelPerformChange() {
+    const bool ec = measures & (kernelEC | kernelS3), s3 = measures & kernelS3;
+    const bool local = measures & kernelLocal, ses = measures & kernelSES;
+
+    uint source         = G1RandomUnlockedNode();
+    uint oldTarget      = (*A)[source];
+    uint newTargetIndex = G2RandomUnlockedNode(oldTarget);
+    uint newTarget      = (*unassignedNodesG2)[newTargetIndex];
+
+    int newAligEdges           = ec ? aligEdges + aligEdgesIncChangeOp(source, oldTarget, newTarget) : -1;
+    int newInducedEdges        = s3 ? inducedEdges + inducedEdgesIncChangeOp(source, oldTarget, newTarget) : -1;
+    double newLocalScoreSum    = local ? localScoreSum + localScoreSumIncChangeOp(sims, source, oldTarget, newTarget) : -1;
+    double newSquaredAligEdges = ses ? squaredAligEdges + squaredAligEdgesIncChangeOp(source, oldTarget, newTarget) : -1;
+
+    double newCurrentScore = 0;
+    if (kernelScoreComparison<measures>(newAligEdges, newInducedEdges, newLocalScoreSum, newSquaredAligEdges, newCurrentScore)) {
+        (*A)[source]                         = newTarget;
+        (*unassignedNodesG2)[newTargetIndex] = oldTarget;
+        (*assignedNodesG2)[oldTarget]        = false;
+        (*assignedNodesG2)[newTarget]        = true;
+        if (ec)  aligEdges        = newAligEdges;
+        if (s3)  inducedEdges     = newInducedEdges;
+        if (ses) squaredAligEdges = newSquaredAligEdges;
+        if (local) localScoreSum   = newLocalScoreSum;
+        currentScore = newCurrentScore;
+    }
+}
+
+template <uint measures>
+void SANA::kernelPerformSwap() {
+    const bool ec = measures & (kernelEC | kernelS3);
+    const bool local = measures & kernelLocal, ses = measures & kernelSES;
+
+    uint source1 = G1RandomUnlockedNode();
+    uint source2 = G1RandomUnlockedNode(source1);
+    uint target1 = (*A)[source1], target2 = (*A)[source2];
+
+    int newAligEdges           = ec ? aligEdges + aligEdgesIncSwapOp(source1, source2, target1, target2) : -1;
+    double newLocalScoreSum    = local ? localScoreSum + localScoreSumIncSwapOp(sims, source1, source2, target1, target2) : -1;
+    double newSquaredAligEdges = ses ? squaredAligEdges + squaredAligEdgesIncSwapOp(source1, source2, target1, target2) : -1;
+
+    double newCurrentScore = 0;
+    if (kernelScoreComparison<measures>(newAligEdges, inducedEdges, newLocalScoreSum, newSquaredAligEdges, newCurrentScore)) {
+        (*A)[source1] = target2;
+        (*A)[source2] = target1;
+        if (ec)  aligEdges        = newAligEdges;
+        if (ses) squaredAligEdges = newSquaredAligEdges;
+        if (local) localScoreSum   = newLocalScoreSum;
+        currentScore = newCurrentScore;
+    }
+}
+
+//same as the Score::sum case of scoreComparison, restricted to the kernel's measures
+template <uint measures>
+bool SANA::kernelScoreComparison(double newAligEdges, double newInducedEdges, double newLocalScoreSum,
+        double newSquaredAligEdges, double& newCurrentScore) {
+    if (measures & kernelEC)    newCurrentScore += ecWeight * (newAligEdges / g1Edges);
+    if (measures & kernelS3)    newCurrentScore += s3Weight * (newAligEdges / (g1Edges + newInducedEdges - newAligEdges));
+    if (measures & kernelLocal) newCurrentScore += localWeight * (newLocalScoreSum / n1);
+#ifdef MULTI_PAIRWISE
+    if (measures & kernelSES)   newCurrentScore += sesWeight * newSquaredAligEdges / SquaredEdgeScore::getDenom();
+#endif
+
+    energyInc = newCurrentScore - currentScore;
+    if (energyInc >= 0) return true;
+
+    double badProbability = exp(energyInc / Temperature);
+    if (iterationsPerformed % 512 == 0) {
+        if (sampledProbability.size() == 1000) {
+            sampledProbability.erase(sampledProbability.begin());
+        }
+        sampledProbability.push_back(badProbability);
+    }
+    return randomReal(gen) <= badProbability;
+}
+
+void SANA::genericSANAIteration() {
     ++iterationsPerformed;
     if(G1->hasNodeTypes())
     {
@@ -1076,27 +1356,31 @@ void SANA::performChange(int type) {
     }
     
 
-    int newAligEdges           = (needAligEdges or needSec) ?  aligEdges + aligEdgesIncChangeOp(source, oldTarget, newTarget) : -1;
-    double newSquaredAligEdges = (needSquaredAligEdges) ?  squaredAligEdges + squaredAligEdgesIncChangeOp(source, oldTarget, newTarget) : -1;
+    int newAligEdges = -1;
+    double newSquaredAligEdges = -1, newWecSum = -1;
+    if (fuseEdgeIncs) {
+        EdgeIncs incs       = edgeIncChangeOp(source, oldTarget, newTarget);
+        newAligEdges        = aligEdges + incs.aligEdges;
+        newSquaredAligEdges = (needSquaredAligEdges) ? squaredAligEdges + incs.squaredAligEdges : -1;
+        newWecSum           = (needWec) ? wecSum + incs.wec : -1;
+    } else {
+        newAligEdges        = (needAligEdges or needSec) ?  aligEdges + aligEdgesIncChangeOp(source, oldTarget, newTarget) : -1;
+        newSquaredAligEdges = (needSquaredAligEdges) ?  squaredAligEdges + squaredAligEdgesIncChangeOp(source, oldTarget, newTarget) : -1;
+        newWecSum           = (needWec) ?  wecSum + WECIncChangeOp(source, oldTarget, newTarget) : -1;
+    }
     int newInducedEdges        = (needInducedEdges) ?  inducedEdges + inducedEdgesIncChangeOp(source, oldTarget, newTarget) : -1;
     double newTCSum            = (needTC) ?  TCSum + TCIncChangeOp(source, oldTarget, newTarget) : -1;
     double newLocalScoreSum    = (needLocal) ? localScoreSum + localScoreSumIncChangeOp(sims, source, oldTarget, newTarget) : -1;
-    double newWecSum           = (needWec) ?  wecSum + WECIncChangeOp(source, oldTarget, newTarget) : -1;
     double newEwecSum          = (needEwec) ?  ewecSum + EWECIncChangeOp(source, oldTarget, newTarget) : -1;
     double newNcSum            = (needNC) ? ncSum + ncIncChangeOp(source, oldTarget, newTarget) : -1;
+    double newSpcSum           = (needSpc) ? spcSum + spc->changeOpDelta(*A, source, oldTarget, newTarget) : -1;
+    double newLccsSize         = (needLccs) ? lccs->changeOpLargest(*A, source, newTarget) : -1;
 
     
 
 
-    map<string, double> newLocalScoreSumMap;
-    if (needLocal) {
-        newLocalScoreSumMap = map<string, double>(*localScoreSumMap);
-        for(auto &item : newLocalScoreSumMap)
-            item.second += localScoreSumIncChangeOp(localSimMatrixMap[item.first], source, oldTarget, newTarget);
-    }
-
     double newCurrentScore = 0;
-    bool makeChange = scoreComparison(newAligEdges, newInducedEdges, newTCSum, newLocalScoreSum, newWecSum, newNcSum, newCurrentScore, newEwecSum, newSquaredAligEdges);
+    bool makeChange = scoreComparison(newAligEdges, newInducedEdges, newTCSum, newLocalScoreSum, newWecSum, newNcSum, newCurrentScore, newEwecSum, newSquaredAligEdges, newSpcSum, newLccsSize);
     if (makeChange) {
         (*A)[source]                         = newTarget;
 
@@ -1121,8 +1405,11 @@ void SANA::performChange(int type) {
         wecSum                               = newWecSum;
         ewecSum                              = newEwecSum;
         ncSum                                = newNcSum;
-        if (needLocal)
-            (*localScoreSumMap) = newLocalScoreSumMap;
+        spcSum                               = newSpcSum;
+        if (needLccs) {
+            lccs->commitMove();
+            lccsSize                         = newLccsSize;
+        }
 #if 0
         if(randomReal(gen)<=1) {
         double foo = eval(*A);
@@ -1159,23 +1446,27 @@ void SANA::performSwap(int type) {
     uint source2 = G1RandomUnlockedNode(source1);
     uint target1 = (*A)[source1], target2 = (*A)[source2];
 
-    int newAligEdges           = (needAligEdges or needSec) ?  aligEdges + aligEdgesIncSwapOp(source1, source2, target1, target2) : -1;
-    int newTCSum               = (needTC) ?  TCSum + TCIncSwapOp(source1, source2, target1, target2) : -1;
-    double newSquaredAligEdges = (needSquaredAligEdges) ? squaredAligEdges + squaredAligEdgesIncSwapOp(source1, source2, target1, target2) : -1;
-    double newWecSum           = (needWec) ?  wecSum + WECIncSwapOp(source1, source2, target1, target2) : -1;
+    int newAligEdges = -1;
+    double newSquaredAligEdges = -1, newWecSum = -1;
+    if (fuseEdgeIncs) {
+        EdgeIncs incs       = edgeIncSwapOp(source1, source2, target1, target2);
+        newAligEdges        = aligEdges + incs.aligEdges;
+        newSquaredAligEdges = (needSquaredAligEdges) ? squaredAligEdges + incs.squaredAligEdges : -1;
+        newWecSum           = (needWec) ? wecSum + incs.wec : -1;
+    } else {
+        newAligEdges        = (needAligEdges or needSec) ?  aligEdges + aligEdgesIncSwapOp(source1, source2, target1, target2) : -1;
+        newSquaredAligEdges = (needSquaredAligEdges) ? squaredAligEdges + squaredAligEdgesIncSwapOp(source1, source2, target1, target2) : -1;
+        newWecSum           = (needWec) ?  wecSum + WECIncSwapOp(source1, source2, target1, target2) : -1;
+    }
+    double newTCSum            = (needTC) ?  TCSum + TCIncSwapOp(source1, source2, target1, target2) : -1;
     double newEwecSum          = (needEwec) ?  ewecSum + EWECIncSwapOp(source1, source2, target1, target2) : -1;
     double newNcSum            = (needNC) ? ncSum + ncIncSwapOp(source1, source2, target1, target2) : -1;
     double newLocalScoreSum    = (needLocal) ? localScoreSum + localScoreSumIncSwapOp(sims, source1, source2, target1, target2) : -1;
-
-    map<string, double> newLocalScoreSumMap;
-    if (needLocal) {
-        newLocalScoreSumMap = map<string, double>(*localScoreSumMap);
-        for (auto &item : newLocalScoreSumMap)
-            item.second += localScoreSumIncSwapOp(localSimMatrixMap[item.first], source1, source2, target1, target2);
-    }
+    double newSpcSum           = (needSpc) ? spcSum + spc->swapOpDelta(*A, source1, source2, target1, target2) : -1;
+    double newLccsSize         = (needLccs) ? lccs->swapOpLargest(*A, source1, source2) : -1;
 
     double newCurrentScore = 0;
-    bool makeChange = scoreComparison(newAligEdges, inducedEdges, newTCSum, newLocalScoreSum, newWecSum, newNcSum, newCurrentScore, newEwecSum, newSquaredAligEdges);
+    bool makeChange = scoreComparison(newAligEdges, inducedEdges, newTCSum, newLocalScoreSum, newWecSum, newNcSum, newCurrentScore, newEwecSum, newSquaredAligEdges, newSpcSum, newLccsSize);
 
     if (makeChange) {
         (*A)[source1]       = target2;
@@ -1186,10 +1477,13 @@ void SANA::performSwap(int type) {
         wecSum              = newWecSum;
         ewecSum             = newEwecSum;
         ncSum               = newNcSum;
+        spcSum              = newSpcSum;
+        if (needLccs) {
+            lccs->commitMove();
+            lccsSize        = newLccsSize;
+        }
         currentScore        = newCurrentScore;
         squaredAligEdges    = newSquaredAligEdges;
-        if (needLocal)
-            (*localScoreSumMap) = newLocalScoreSumMap;
 #if 0
         if (randomReal(gen) <= 1) {
             double foo = eval(*A);
@@ -1225,7 +1519,7 @@ void SANA::performSwap(int type) {
 #endif
 }
 
-bool SANA::scoreComparison(double newAligEdges, double newInducedEdges, double newTCSum, double newLocalScoreSum, double newWecSum, double newNcSum, double& newCurrentScore, double newEwecSum, double newSquaredAligEdges) {
+bool SANA::scoreComparison(double newAligEdges, double newInducedEdges, double newTCSum, double newLocalScoreSum, double newWecSum, double newNcSum, double& newCurrentScore, double newEwecSum, double newSquaredAligEdges, double newSpcSum, double newLccsSize) {
     bool makeChange = false;
     bool wasBadMove = false;
     double badProbability = 0;
@@ -1243,6 +1537,8 @@ bool SANA::scoreComparison(double newAligEdges, double newInducedEdges, double n
         newCurrentScore += wecWeight * (newWecSum / (2 * g1Edges));
         newCurrentScore += ewecWeight * (newEwecSum);
         newCurrentScore += ncWeight * (newNcSum / trueA.back());
+        if (needSpc) newCurrentScore += spcWeight * spc->score(newSpcSum);
+        if (needLccs) newCurrentScore += lccsnWeight * (newLccsSize / n1);
 #ifdef MULTI_PAIRWISE
         newCurrentScore += mecWeight * (newAligEdges / (g1WeightedEdges + g2WeightedEdges));
         newCurrentScore += sesWeight * newSquaredAligEdges / SquaredEdgeScore::getDenom();
@@ -1414,11 +1710,13 @@ bool SANA::scoreComparison(double newAligEdges, double newInducedEdges, double n
 int SANA::aligEdgesIncChangeOp(uint source, uint oldTarget, uint newTarget) {
     int res = 0;
     const uint n = G1AdjLists[source].size();
+    auto&& oldRow = G2Matrix[oldTarget];
+    auto&& newRow = G2Matrix[newTarget];
     uint neighbor;
     for (uint i = 0; i < n; ++i) {
         neighbor = G1AdjLists[source][i];
-        res -= G2Matrix[oldTarget][(*A)[neighbor]];
-        res += G2Matrix[newTarget][(*A)[neighbor]];
+        res -= oldRow[(*A)[neighbor]];
+        res += newRow[(*A)[neighbor]];
     }
     return res;
 }
@@ -1426,18 +1724,20 @@ int SANA::aligEdgesIncChangeOp(uint source, uint oldTarget, uint newTarget) {
 int SANA::aligEdgesIncSwapOp(uint source1, uint source2, uint target1, uint target2) {
     int res = 0;
     const uint n = G1AdjLists[source1].size();
+    auto&& row1 = G2Matrix[target1];
+    auto&& row2 = G2Matrix[target2];
     uint neighbor;
     uint i = 0;
     for (; i < n; ++i) {
         neighbor = G1AdjLists[source1][i];
-        res -= G2Matrix[target1][(*A)[neighbor]];
-        res += G2Matrix[target2][(*A)[neighbor]];
+        res -= row1[(*A)[neighbor]];
+        res += row2[(*A)[neighbor]];
     }
     const uint m = G1AdjLists[source2].size();
     for (i = 0; i < m; ++i) {
         neighbor = G1AdjLists[source2][i];
-        res -= G2Matrix[target2][(*A)[neighbor]];
-        res += G2Matrix[target1][(*A)[neighbor]];
+        res -= row2[(*A)[neighbor]];
+        res += row1[(*A)[neighbor]];
     }
     //address case swapping between adjacent nodes with adjacent images:
 #ifdef MULTI_PAIRWISE
@@ -1527,11 +1827,19 @@ int SANA::inducedEdgesIncChangeOp(uint source, uint oldTarget, uint newTarget) {
     return res;
 }
 
-double SANA::localScoreSumIncChangeOp(vector<vector<float> > const & sim, uint const & source, uint const & oldTarget, uint const & newTarget) {
+//sums from scratch the local sims of the current alignment
+void SANA::sumLocalScores() {
+    localScoreSum = 0;
+    for (uint i = 0; i < n1; i++) {
+        localScoreSum += sims[i][(*A)[i]];
+    }
+}
+
+double SANA::localScoreSumIncChangeOp(SimMatrix const & sim, uint const & source, uint const & oldTarget, uint const & newTarget) {
     return sim[source][newTarget] - sim[source][oldTarget];
 }
 
-double SANA::localScoreSumIncSwapOp(vector<vector<float> > const & sim, uint const & source1, uint const & source2, uint const & target1, uint const & target2) {
+double SANA::localScoreSumIncSwapOp(SimMatrix const & sim, uint const & source1, uint const & source2, uint const & target1, uint const & target2) {
     return sim[source1][target2] - sim[source1][target1] + sim[source2][target1] - sim[source2][target2];
 }
 
@@ -1592,6 +1900,74 @@ double SANA::WECIncSwapOp(uint source1, uint source2, uint target1, uint target2
     return res;
 }
 
+//same per-edge value as SQRDIFF, including its clamping
+static inline int squaredEdgeInc(int edgeVal) {
+    int diff = 2*((edgeVal < 1000 ? edgeVal : 0) + 1);
+    return diff > 0 ? diff : 0;
+}
+
+//accumulates the increments due to source moving from oldTarget to newTarget,
+//reading each neighbor's image and its two G2Matrix entries only once
+template <bool ses, bool wec>
+void SANA::edgeIncNeighborhood(uint source, uint oldTarget, uint newTarget, EdgeIncs& incs) {
+    auto&& oldRow = G2Matrix[oldTarget];
+    auto&& newRow = G2Matrix[newTarget];
+    const vector<uint>& neighbors = G1AdjLists[source];
+    const uint n = neighbors.size();
+    const double oldSim = wec ? wecSims[source][oldTarget] : 0;
+    const double newSim = wec ? wecSims[source][newTarget] : 0;
+    for (uint i = 0; i < n; ++i) {
+        const uint neighbor = neighbors[i];
+        const uint image    = (*A)[neighbor];
+        const int oldEdge   = oldRow[image];
+        const int newEdge   = newRow[image];
+        incs.aligEdges += newEdge - oldEdge;
+        if (ses) {
+            incs.squaredAligEdges += squaredEdgeInc(newEdge) - squaredEdgeInc(oldEdge);
+        }
+        if (wec and (oldEdge or newEdge)) {
+            const double neighborSim = wecSims[neighbor][image];
+            if (oldEdge) incs.wec -= oldSim + neighborSim;
+            if (newEdge) incs.wec += newSim + neighborSim;
+        }
+    }
+}
+
+template <bool ses, bool wec>
+void SANA::edgeIncSwapOp(uint source1, uint source2, uint target1, uint target2, EdgeIncs& incs) {
+    edgeIncNeighborhood<ses, wec>(source1, target1, target2, incs);
+    edgeIncNeighborhood<ses, wec>(source2, target2, target1, incs);
+    //address case swapping between adjacent nodes with adjacent images:
+#ifdef MULTI_PAIRWISE
+    incs.aligEdges += (-1 << 1) & (G1Matrix[source1][source2] + G2Matrix[target1][target2]);
+    const bool adjacent = G1Matrix[source1][source2] > 0 and G2Matrix[target1][target2] > 0;
+#else
+    incs.aligEdges += 2*(G1Matrix[source1][source2] & G2Matrix[target1][target2]);
+    const bool adjacent = G1Matrix[source1][source2] and G2Matrix[target1][target2];
+#endif
+    if (adjacent) {
+        if (ses) incs.squaredAligEdges += 2 * SQRDIFF(target1, source2);
+        if (wec) incs.wec += 2*wecSims[source1][target1] + 2*wecSims[source2][target2];
+    }
+}
+
+//only called when EC is needed along with SES and/or WEC (see fuseEdgeIncs)
+SANA::EdgeIncs SANA::edgeIncChangeOp(uint source, uint oldTarget, uint newTarget) {
+    EdgeIncs incs;
+    if (needSquaredAligEdges and needWec) edgeIncNeighborhood<true, true>(source, oldTarget, newTarget, incs);
+    else if (needWec)                     edgeIncNeighborhood<false, true>(source, oldTarget, newTarget, incs);
+    else                                  edgeIncNeighborhood<true, false>(source, oldTarget, newTarget, incs);
+    return incs;
+}
+
+SANA::EdgeIncs SANA::edgeIncSwapOp(uint source1, uint source2, uint target1, uint target2) {
+    EdgeIncs incs;
+    if (needSquaredAligEdges and needWec) edgeIncSwapOp<true, true>(source1, source2, target1, target2, incs);
+    else if (needWec)                     edgeIncSwapOp<false, true>(source1, source2, target1, target2, incs);
+    else                                  edgeIncSwapOp<true, false>(source1, source2, target1, target2, incs);
+    return incs;
+}
+
 double SANA::EWECIncChangeOp(uint source, uint oldTarget, uint newTarget){
     double score = 0;
     score = (EWECSimCombo(source, newTarget)) - (EWECSimCombo(source, oldTarget));
@@ -1608,91 +1984,90 @@ double SANA::EWECIncSwapOp(uint source1, uint source2, uint target1, uint target
 }
 
 double SANA::EWECSimCombo(uint source, uint target){
-    double score = 0;
-    const uint n = G1AdjLists[source].size();
-    uint neighbor;
-    for (uint i = 0; i < n; ++i) {
-        neighbor = G1AdjLists[source][i];
-        if (G2Matrix[target][(*A)[neighbor]]) {
-            int e1 = ewec->getRowIndex(source, neighbor);
-            int e2 = ewec->getColIndex(target, (*A)[neighbor]);
-            score+=ewec->getScore(e2,e1);
-        }
-    }
-    return score/(2*g1Edges);
-}
-
-double SANA::TCIncChangeOp(uint source, uint oldTarget, uint newTarget){
-    double deltaTriangles = 0;
-    const uint n = G1AdjLists[source].size();
-    uint neighbor1, neighbor2;
-    for(uint i = 0; i < n; ++i){
-        for(uint j = i+1; j < n; ++j){
-            neighbor1 = G1AdjLists[source][i];
-            neighbor2 = G1AdjLists[source][j];
-            if(G1Matrix[neighbor1][neighbor2]){
-                //G1 has a triangle
-                if(G2Matrix[oldTarget][(*A)[neighbor1]] and G2Matrix[oldTarget][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]]){
-                    //G2 HAD a triangle
-                    deltaTriangles -= 1;
-                }
-
-                if(G2Matrix[newTarget][(*A)[neighbor1]] and G2Matrix[newTarget][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]]){
-                    //G2 GAINS a triangle
-                    deltaTriangles += 1;
+    return ewec->simCombo(*A, source, target)/(2*g1Edges);
+}
+
+void SANA::initG1TriangleLists() {
+    //merge sorted adjacency lists: for every edge (u,v) with u < v, the common
+    //neighbors w > v close the triangle {u,v,w}, which is recorded at all 3 nodes
+    vector<vector<uint> > sortedAdjLists(G1AdjLists);
+    for (auto& adjList : sortedAdjLists) {
+        sort(adjList.begin(), adjList.end());
+    }
+    G1TriangleLists = vector<vector<uint> > (n1);
+    for (uint u = 0; u < n1; ++u) {
+        const vector<uint>& uAdj = sortedAdjLists[u];
+        for (uint v : uAdj) {
+            if (v <= u) continue;
+            const vector<uint>& vAdj = sortedAdjLists[v];
+            auto i = upper_bound(uAdj.begin(), uAdj.end(), v);
+            auto j = upper_bound(vAdj.begin(), vAdj.end(), v);
+            while (i != uAdj.end() and j != vAdj.end()) {
+                if (*i < *j) ++i;
+                else if (*j < *i) ++j;
+                else {
+                    uint w = *i;
+                    G1TriangleLists[u].push_back(v); G1TriangleLists[u].push_back(w);
+                    G1TriangleLists[v].push_back(u); G1TriangleLists[v].push_back(w);
+                    G1TriangleLists[w].push_back(u); G1TriangleLists[w].push_back(v);
+                    ++i; ++j;
                 }
             }
         }
     }
-    return ((double)deltaTriangles/maxTriangles);
 }
 
-double SANA::TCIncSwapOp(uint source1, uint source2, uint target1, uint target2){
-    double deltaTriangles = 0;
-    const uint n = G1AdjLists[source1].size();
-    uint neighbor1, neighbor2;
-    for(uint i = 0; i < n; ++i){
-        for(uint j = i+1; j < n; ++j){
-            neighbor1 = G1AdjLists[source1][i];
-            neighbor2 = G1AdjLists[source1][j];
-            if(G1Matrix[neighbor1][neighbor2]){
-                //G1 has a triangle
-                if(G2Matrix[target1][(*A)[neighbor1]] and G2Matrix[target1][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]]){
-                    //G2 HAD a triangle
-                    deltaTriangles -= 1;
-                }
-
-                if((G2Matrix[target2][(*A)[neighbor1]] and G2Matrix[target2][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]])
-                || (neighbor1 == source2 and G2Matrix[target2][target1] and G2Matrix[target2][(*A)[neighbor2]] and G2Matrix[target1][(*A)[neighbor2]])
-                || (neighbor2 == source2 and G2Matrix[target2][(*A)[neighbor1]] and G2Matrix[target2][target1] and G2Matrix[(*A)[neighbor1]][target1])) {
-                    //G2 GAINS a triangle
-                    deltaTriangles += 1;
-                }
-            }
+//number of G2 triangles gained minus lost among the images of the G1 triangles
+//through source when it moves from oldTarget to newTarget
+int SANA::trianglesIncChangeOp(const vector<uint>& A, uint source, uint oldTarget, uint newTarget) {
+    int deltaTriangles = 0;
+    auto&& oldRow = G2Matrix[oldTarget];
+    auto&& newRow = G2Matrix[newTarget];
+    const vector<uint>& triangles = G1TriangleLists[source];
+    const uint n = triangles.size();
+    for (uint k = 0; k < n; k += 2) {
+        uint image1 = A[triangles[k]], image2 = A[triangles[k+1]];
+        bool had   = oldRow[image1] and oldRow[image2];
+        bool gains = newRow[image1] and newRow[image2];
+        if (had != gains and G2Matrix[image1][image2]) {
+            deltaTriangles += gains ? 1 : -1;
         }
     }
-    const uint m = G1AdjLists[source2].size();
-    for(uint i = 0; i < m; ++i){
-        for(uint j = i+1; j < m; ++j){
-            neighbor1 = G1AdjLists[source2][i];
-            neighbor2 = G1AdjLists[source2][j];
-            if(G1Matrix[neighbor1][neighbor2]){
-                //G1 has a triangle
-                if(G2Matrix[target2][(*A)[neighbor1]] and G2Matrix[target2][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]]){
-                    //G2 HAD a triangle
-                    deltaTriangles -= 1;
-                }
+    return deltaTriangles;
+}
 
-                if((G2Matrix[target1][(*A)[neighbor1]] and G2Matrix[target1][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]])
-                   || (neighbor1 == source1 and G2Matrix[target1][target2] and G2Matrix[target1][(*A)[neighbor2]] and G2Matrix[target2][(*A)[neighbor2]])
-                   || (neighbor2 == source1 and G2Matrix[target1][(*A)[neighbor1]] and G2Matrix[target1][target2] and G2Matrix[(*A)[neighbor1]][target2])){
-                    //G2 GAINS a triangle
-                    deltaTriangles += 1;
-                }
-            }
+//same for the triangles through source when it moves from target to otherTarget
+//while the node other moves from otherTarget to target (one half of a swap)
+int SANA::trianglesIncSwapOp(const vector<uint>& A, uint source, uint other, uint target, uint otherTarget) {
+    int deltaTriangles = 0;
+    auto&& oldRow = G2Matrix[target];
+    auto&& newRow = G2Matrix[otherTarget];
+    const vector<uint>& triangles = G1TriangleLists[source];
+    const uint n = triangles.size();
+    for (uint k = 0; k < n; k += 2) {
+        uint neighbor1 = triangles[k], neighbor2 = triangles[k+1];
+        uint image1 = A[neighbor1], image2 = A[neighbor2];
+        if (oldRow[image1] and oldRow[image2] and G2Matrix[image1][image2]) {
+            //G2 HAD a triangle
+            deltaTriangles -= 1;
+        }
+        if (neighbor1 == other) image1 = target;
+        if (neighbor2 == other) image2 = target;
+        if (newRow[image1] and newRow[image2] and G2Matrix[image1][image2]) {
+            //G2 GAINS a triangle
+            deltaTriangles += 1;
         }
     }
+    return deltaTriangles;
+}
 
+double SANA::TCIncChangeOp(uint source, uint oldTarget, uint newTarget){
+    return ((double)trianglesIncChangeOp(*A, source, oldTarget, newTarget)/maxTriangles);
+}
+
+double SANA::TCIncSwapOp(uint source1, uint source2, uint target1, uint target2){
+    int deltaTriangles = trianglesIncSwapOp(*A, source1, source2, target1, target2)
+                       + trianglesIncSwapOp(*A, source2, source1, target2, target1);
     return ((double)deltaTriangles/maxTriangles);
 }
 
@@ -1718,8 +2093,10 @@ void SANA::trackProgress(long long int i, bool end) {
     bool printScores = false;
     bool checkScores = true;
 
-    cout << i/iterationsPerStep << " (" << timer.elapsed() << "s): score = " << currentScore;
-    cout <<  " P(" << avgEnergyInc << ", " << Temperature << ") = " << acceptingProbability(avgEnergyInc, Temperature) << ", pBad = " << trueAcceptingProbability() << endl;
+    if (chainId == 0) {
+        cout << i/iterationsPerStep << " (" << timer.elapsed() << "s): score = " << currentScore;
+        cout <<  " P(" << avgEnergyInc << ", " << Temperature << ") = " << acceptingProbability(avgEnergyInc, Temperature) << ", pBad = " << trueAcceptingProbability() << endl;
+    }
 
     if (not (printDetails or printScores or checkScores)) return;
     Alignment Al(*A);
@@ -1734,9 +2111,13 @@ void SANA::trackProgress(long long int i, bool end) {
         SymmetricEdgeCoverage SEC(G1,G2);
         cout << "S3: " << S3.eval(Al) << "  EC: " << EC.eval(Al) << "  ICS: " << ICS.eval(Al) << "  SEC: " << SEC.eval(Al) <<endl;
     }
+    if (needLocal) {
+        //billions of float increments drift away from the true sums
+        sumLocalScores();
+    }
     if (checkScores) {
         double realScore = eval(Al);
-        if (fabs(realScore-currentScore) > 0.000001) {
+        if (fabs(realScore-currentScore) > 0.000001 + localQuantizationError) {
             cerr << "internal error: incrementally computed score (" << currentScore;
             cerr << ") is not correct (" << realScore << ")" << endl;
             currentScore = realScore;
@@ -1843,8 +2224,9 @@ double LOG10_LOW_TEMP = 0, LOG10_HIGH_TEMP = 0, LOG10_NUM_STEPS = 0;
 double SANA::temperatureBracket(double LIMIT, bool is_high){
 	int i = 0;
 	while (true){
-		double pBadi = pForTInitial(pow(10,i));
-		double pBadi1 = pForTInitial(pow(10,i+1));
+		vector<double> pBads = pForTInitials({pow(10,i), pow(10,i+1)});
+		double pBadi = pBads[0];
+		double pBadi1 = pBads[1];
 		cout << "Testing 10 ^ " << i << " pBad = " << pBadi << endl;
 		if (pBadi < LIMIT && pBadi1 >= LIMIT){
 			break;
@@ -1860,49 +2242,29 @@ double SANA::temperatureBracket(double LIMIT, bool is_high){
 
 void SANA::findingUpperLowerTemperatureBound(double & LOG10_LOW_TEMP, double & LOG10_HIGH_TEMP){
 
-	double pBadLow = pForTInitial(pow(10,LOG10_LOW_TEMP));
-	double pBadHigh = pForTInitial(pow(10,LOG10_HIGH_TEMP));
+	vector<double> pBads = pForTInitials({pow(10,LOG10_LOW_TEMP), pow(10,LOG10_HIGH_TEMP)});
+	double pBadLow = pBads[0];
+	double pBadHigh = pBads[1];
 
 	cout << "Finding the Upper and Lower Bounds of the Temperature ... " << endl;
 
 	if (pBadLow > PBAD_LOW_TEMP_LIMIT && pBadHigh > PBAD_HIGH_TEMP_LIMIT){
 		//both need to go down
-		while(true){
-			pBadHigh = pForTInitial(pow(10,LOG10_HIGH_TEMP));
-			cout << "Testing High Temperature 10^" << LOG10_HIGH_TEMP << " pBad = " << pBadHigh << endl;				
-			if (pBadHigh < PBAD_HIGH_TEMP_LIMIT)
-				break;
-			LOG10_HIGH_TEMP--;
-		}
+		LOG10_HIGH_TEMP = scanTemperatureExponents(LOG10_HIGH_TEMP, -1,
+			[](double pBad) { return pBad < PBAD_HIGH_TEMP_LIMIT; }, "High");
 
 		LOG10_LOW_TEMP = LOG10_HIGH_TEMP-1; //We know that LOW TEMP HAS TO BE ATLEAST AS KNOW AS THE HIGH TEMP..Saves us extra computation!
 
-		while(true){
-			pBadLow = pForTInitial(pow(10,LOG10_LOW_TEMP));	
-			cout << "Testing Low Temperature 10^" << LOG10_LOW_TEMP << " pBad = " << pBadLow << endl;
-			LOG10_LOW_TEMP--;
-			if(pBadLow < PBAD_LOW_TEMP_LIMIT)
-				break;
-		}	
-		
+		LOG10_LOW_TEMP = scanTemperatureExponents(LOG10_LOW_TEMP, -1,
+			[](double pBad) { return pBad < PBAD_LOW_TEMP_LIMIT; }, "Low") - 1;
 	}
 	else if (pBadLow < PBAD_LOW_TEMP_LIMIT && pBadHigh < PBAD_HIGH_TEMP_LIMIT){
 		//both need to go up
-		while(true){
-			pBadLow = pForTInitial(pow(10,LOG10_LOW_TEMP));	
-			cout << "Testing Low Temperature 10^" << LOG10_LOW_TEMP << " pBad = " << pBadLow << endl;
-			if(pBadLow > PBAD_LOW_TEMP_LIMIT)
-				break;
-			LOG10_LOW_TEMP++;
-		}	
+		LOG10_LOW_TEMP = scanTemperatureExponents(LOG10_LOW_TEMP, 1,
+			[](double pBad) { return pBad > PBAD_LOW_TEMP_LIMIT; }, "Low");
 		LOG10_HIGH_TEMP = LOG10_LOW_TEMP+1; //We know that LOW TEMP HAS TO BE ATLEAST AS KNOW AS THE HIGH TEMP..Saves us extra computation!
-		while(true){
-			pBadHigh = pForTInitial(pow(10,LOG10_HIGH_TEMP));
-			cout << "Testing High Temperature 10^" << LOG10_HIGH_TEMP << " pBad = " << pBadHigh << endl;				
-			LOG10_HIGH_TEMP++;
-			if (pBadHigh > PBAD_HIGH_TEMP_LIMIT)
-				break;
-		}
+		LOG10_HIGH_TEMP = scanTemperatureExponents(LOG10_HIGH_TEMP, 1,
+			[](double pBad) { return pBad > PBAD_HIGH_TEMP_LIMIT; }, "High") + 1;
 	}
 	else{ //We have to go both ways to see how much high the HIGH_TEMP needs to go, and how much low the LOW_TEMP needs to go
 		LOG10_HIGH_TEMP = temperatureBracket(PBAD_HIGH_TEMP_LIMIT, true);
@@ -1929,54 +2291,72 @@ void SANA::searchTemperaturesByLinearRegression() {
     int T_i;
     double log_temp;
     
+    vector<double> gridTemperatures, gridScores;
 	for(T_i = 0; T_i <= LOG10_NUM_STEPS; T_i++){
 	log_temp = LOG10_LOW_TEMP + T_i*(LOG10_HIGH_TEMP-LOG10_LOW_TEMP)/LOG10_NUM_STEPS;
-        pbadMap[log_temp] = pForTInitial(pow(10, log_temp));
-        cout << T_i << " temperature: " << pow(10, log_temp) << " pBad: " << pbadMap[log_temp] << " score: " << eval(*A) << endl;
+        gridTemperatures.push_back(pow(10, log_temp));
+    }
+    vector<double> gridPBads = pForTInitials(gridTemperatures, &gridScores);
+	for(T_i = 0; T_i <= LOG10_NUM_STEPS; T_i++){
+	log_temp = LOG10_LOW_TEMP + T_i*(LOG10_HIGH_TEMP-LOG10_LOW_TEMP)/LOG10_NUM_STEPS;
+        pbadMap[log_temp] = gridPBads[T_i];
+        cout << T_i << " temperature: " << pow(10, log_temp) << " pBad: " << pbadMap[log_temp] << " score: " << gridScores[T_i] << endl;
     }
     for (T_i=0; T_i <= LOG10_NUM_STEPS; T_i++){
 	log_temp = LOG10_LOW_TEMP + T_i*(LOG10_HIGH_TEMP-LOG10_LOW_TEMP)/LOG10_NUM_STEPS;
         if(pbadMap[log_temp] > FinalPBad)
             break;
     }
-    double binarySearchLeftEnd = LOG10_LOW_TEMP + (T_i-1)*(LOG10_HIGH_TEMP-LOG10_LOW_TEMP)/LOG10_NUM_STEPS;
-    double binarySearchRightEnd = log_temp;
-    double mid = (binarySearchRightEnd + binarySearchLeftEnd) / 2;
-    cout << "Increasing sample density near tFinal. " << "left bound: " << pow(10, binarySearchLeftEnd) << ", right bound: " << pow(10, binarySearchRightEnd) << endl;
-    for(int j = 0; j < 4; ++j){
-        double temperature = pow(10, mid);
-        double probability = pForTInitial(temperature);
-        pbadMap[mid] = probability;
-        cout << "Temperature: " << temperature << " pbad: " << probability << " score: " << eval(*A) << endl;
-        if(probability > FinalPBad){
-            binarySearchRightEnd = mid;
-            mid = (binarySearchRightEnd + binarySearchLeftEnd) / 2;
-        } else if(probability < FinalPBad/10){
-            binarySearchLeftEnd = mid;
-            mid = (binarySearchRightEnd + binarySearchLeftEnd) / 2;
-        }
-    }
+    double finalLeftEnd = LOG10_LOW_TEMP + (T_i-1)*(LOG10_HIGH_TEMP-LOG10_LOW_TEMP)/LOG10_NUM_STEPS;
+    double finalRightEnd = log_temp;
     for (T_i = LOG10_NUM_STEPS; T_i >= 0; T_i--){
 	log_temp = LOG10_LOW_TEMP + T_i*(LOG10_HIGH_TEMP-LOG10_LOW_TEMP)/LOG10_NUM_STEPS;
         if(pbadMap[log_temp] < InitialPBad)
             break;
     }
-    binarySearchLeftEnd = log_temp;
-    binarySearchRightEnd = LOG10_LOW_TEMP + (T_i+1)*(LOG10_HIGH_TEMP-LOG10_LOW_TEMP)/LOG10_NUM_STEPS;
-    mid = (binarySearchRightEnd + binarySearchLeftEnd) / 2;
-    cout << "Increasing sample density near tInitial. " << "left bound: " << pow(10, binarySearchLeftEnd) << ", right bound: " << pow(10, binarySearchRightEnd) << endl;
-    for(int j = 0; j < 4; ++j){
-        double temperature = pow(10, mid);
-        double probability = pForTInitial(temperature);
-        pbadMap[mid] = probability;
-        cout << "Temperature: " << temperature << " pbad: " << probability << " score: " << eval(*A) << endl;
-        if(probability > 0.995){
-            binarySearchRightEnd = mid;
-            mid = (binarySearchRightEnd + binarySearchLeftEnd) / 2;
-        } else if(probability < InitialPBad){
-            binarySearchLeftEnd = mid;
-            mid = (binarySearchRightEnd + binarySearchLeftEnd) / 2;
+    double initialLeftEnd = log_temp;
+    double initialRightEnd = LOG10_LOW_TEMP + (T_i+1)*(LOG10_HIGH_TEMP-LOG10_LOW_TEMP)/LOG10_NUM_STEPS;
+
+    //the samples near tFinal and near tInitial do not depend on each other, so
+    //the two bisections run concurrently when there are threads for them
+    vector<Alignment> finalStartAligs, initialStartAligs;
+    for (int j = 0; j < 4; ++j) {
+        finalStartAligs.push_back(getStartingAlignment());
+        initialStartAligs.push_back(getStartingAlignment());
+    }
+    vector<double> finalLogTemps, finalPBads, finalScores, initialLogTemps, initialPBads, initialScores;
+    if (numProbeThreads() > 1) {
+        vector<SANA*> probes(2);
+        for (uint t = 0; t < 2; t++) {
+            probes[t] = new SANA(*this);
+            probes[t]->chainId = t+1;
+            probes[t]->gen = mt19937(randInt(0, numeric_limits<int>::max()));
+        }
+        thread finalThread([&]() {
+            probes[0]->bisectTemperatures(finalLeftEnd, finalRightEnd, FinalPBad, FinalPBad/10,
+                finalStartAligs, finalLogTemps, finalPBads, finalScores);
+        });
+        probes[1]->bisectTemperatures(initialLeftEnd, initialRightEnd, 0.995, InitialPBad,
+            initialStartAligs, initialLogTemps, initialPBads, initialScores);
+        finalThread.join();
+        for (uint t = 0; t < 2; t++) {
+            delete probes[t];
         }
+    } else {
+        bisectTemperatures(finalLeftEnd, finalRightEnd, FinalPBad, FinalPBad/10,
+            finalStartAligs, finalLogTemps, finalPBads, finalScores);
+        bisectTemperatures(initialLeftEnd, initialRightEnd, 0.995, InitialPBad,
+            initialStartAligs, initialLogTemps, initialPBads, initialScores);
+    }
+    cout << "Increasing sample density near tFinal. " << "left bound: " << pow(10, finalLeftEnd) << ", right bound: " << pow(10, finalRightEnd) << endl;
+    for (uint j = 0; j < finalLogTemps.size(); ++j) {
+        pbadMap[finalLogTemps[j]] = finalPBads[j];
+        cout << "Temperature: " << pow(10, finalLogTemps[j]) << " pbad: " << finalPBads[j] << " score: " << finalScores[j] << endl;
+    }
+    cout << "Increasing sample density near tInitial. " << "left bound: " << pow(10, initialLeftEnd) << ", right bound: " << pow(10, initialRightEnd) << endl;
+    for (uint j = 0; j < initialLogTemps.size(); ++j) {
+        pbadMap[initialLogTemps[j]] = initialPBads[j];
+        cout << "Temperature: " << pow(10, initialLogTemps[j]) << " pbad: " << initialPBads[j] << " score: " << initialScores[j] << endl;
     }
     LinearRegression linearRegression;
     linearRegression.setup(pbadMap);
@@ -2232,7 +2612,10 @@ double SANA::pForTInitial(double TInitial) {
 
     //Establish the amount of iterations per second before getPforTInitial otherwise it will be calculated with iterationsPerStep = 100000
     getIterPerSecond();
+    return pForTInitial(TInitial, getStartingAlignment());
+}
 
+double SANA::pForTInitial(double TInitial, const Alignment& startA) {
     uint ITERATIONS = 10000.+100.*n1+10.*n2+n1*n2*0.1; //heuristic value
     ITERATIONS = 100000;
     double oldIterationsPerStep = this->iterationsPerStep;
@@ -2247,7 +2630,7 @@ double SANA::pForTInitial(double TInitial) {
 
     long long int iter = 0;
     // simpleRun(Alignment::random(n1, n2), 0.0, iter);
-    double result = getPforTInitial(getStartingAlignment(), 1.0, iter);
+    double result = getPforTInitial(startA, 1.0, iter);
     this->iterationsPerStep = oldIterationsPerStep;
     this->TInitial = oldTInitial;
     constantTemp = false;
@@ -2257,6 +2640,95 @@ double SANA::pForTInitial(double TInitial) {
     return result;
 }
 
+uint SANA::numProbeThreads() {
+    if (not measuresAreThreadSafe()) return 1;
+    return max(1u, thread::hardware_concurrency());
+}
+
+vector<double> SANA::pForTInitials(const vector<double>& temperatures, vector<double>* scores) {
+    //as in runIndependentChains, what is not thread safe (the calibration, the
+    //global RNG of the starting alignments and of the seeds) is done here.
+    //Each probe gets a seed of its own, so successive calls do not replay the
+    //same random streams and the result does not depend on the thread it ran on
+    getIterPerSecond();
+    uint n = temperatures.size();
+    vector<Alignment> startAligs;
+    vector<uint> seeds;
+    for (uint i = 0; i < n; i++) {
+        startAligs.push_back(getStartingAlignment());
+        seeds.push_back(randInt(0, numeric_limits<int>::max()));
+    }
+    vector<double> pBads(n), probeScores(n);
+    uint numProbes = min(n, numProbeThreads());
+    if (numProbes <= 1) {
+        for (uint i = 0; i < n; i++) {
+            pBads[i] = pForTInitial(temperatures[i], startAligs[i]);
+            probeScores[i] = eval(*A);
+        }
+    } else {
+        vector<SANA*> probes(numProbes);
+        for (uint t = 0; t < numProbes; t++) {
+            probes[t] = new SANA(*this);
+            probes[t]->chainId = t+1;
+        }
+        atomic<uint> nextProbe(0);
+        auto worker = [&](uint t) {
+            for (uint i = nextProbe++; i < n; i = nextProbe++) {
+                probes[t]->gen = mt19937(seeds[i]);
+                pBads[i] = probes[t]->pForTInitial(temperatures[i], startAligs[i]);
+                probeScores[i] = probes[t]->eval(*(probes[t]->A));
+            }
+        };
+        vector<thread> threads;
+        for (uint t = 0; t < numProbes; t++) {
+            threads.push_back(thread(worker, t));
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (uint t = 0; t < numProbes; t++) {
+            delete probes[t];
+        }
+    }
+    if (scores) *scores = probeScores;
+    return pBads;
+}
+
+int SANA::scanTemperatureExponents(int start, int step, const function<bool(double)>& stop, const string& label) {
+    //with a single probe thread this probes exactly the exponents the
+    //sequential search would; otherwise the extra ones are speculative
+    uint batchSize = numProbeThreads();
+    for (int e = start; ; e += batchSize*step) {
+        vector<double> temperatures;
+        for (uint i = 0; i < batchSize; i++) {
+            temperatures.push_back(pow(10, e + (int) i*step));
+        }
+        vector<double> pBads = pForTInitials(temperatures);
+        for (uint i = 0; i < batchSize; i++) {
+            cout << "Testing " << label << " Temperature 10^" << e + (int) i*step << " pBad = " << pBads[i] << endl;
+            if (stop(pBads[i])) return e + (int) i*step;
+        }
+    }
+}
+
+void SANA::bisectTemperatures(double left, double right, double tooHigh, double tooLow,
+        const vector<Alignment>& startAligs, vector<double>& logTemps, vector<double>& pBads, vector<double>& scores) {
+    double mid = (right + left) / 2;
+    for(int j = 0; j < 4; ++j){
+        double probability = pForTInitial(pow(10, mid), startAligs[j]);
+        logTemps.push_back(mid);
+        pBads.push_back(probability);
+        scores.push_back(eval(*A));
+        if(probability > tooHigh){
+            right = mid;
+            mid = (right + left) / 2;
+        } else if(probability < tooLow){
+            left = mid;
+            mid = (right + left) / 2;
+        }
+    }
+}
+
 double SANA::getPforTInitial(const Alignment& startA, double maxExecutionSeconds,
         long long int& iter) {
     double result = 0.0;
@@ -2634,13 +3106,6 @@ void SANA::performChange(Job &job, int type) {
     double newEwecSum          = (needEwec) ?  info.ewecSum + EWECIncChangeOp(job, source, oldTarget, newTarget) : -1;
     double newNcSum            = (needNC) ? info.ncSum + ncIncChangeOp(job, source, oldTarget, newTarget) : -1;
 
-    map<string, double> newLocalScoreSumMap;
-    if (needLocal) {
-        newLocalScoreSumMap = map<string, double>(*info.localScoreSumMap);
-        for(auto &item : newLocalScoreSumMap)
-            item.second += localScoreSumIncChangeOp(localSimMatrixMap[item.first], source, oldTarget, newTarget);
-    }
-
     double newCurrentScore = 0;
     bool makeChange = scoreComparison(job, newAligEdges, newInducedEdges, newTCSum, newLocalScoreSum, newWecSum, newNcSum, newCurrentScore, newEwecSum, newSquaredAligEdges);
     if (makeChange) {
@@ -2668,10 +3133,6 @@ void SANA::performChange(Job &job, int type) {
        info.ncSum                                = newNcSum;
        info.currentScore = newCurrentScore;
        info.squaredAligEdges = newSquaredAligEdges;
-
-       if (needLocal) {
-           (*info.localScoreSumMap) = newLocalScoreSumMap;
-       }      
 #if 0
        if (randomReal(job.gen) <= 1) {
            double foo = eval(*A);
@@ -2697,20 +3158,13 @@ void SANA::performSwap(Job &job, int type) {
     uint target1 = (*A)[source1], target2 = (*A)[source2];
 
     int newAligEdges           = (needAligEdges or needSec) ?  info.aligEdges + aligEdgesIncSwapOp(job, source1, source2, target1, target2) : -1;
-    int newTCSum               = (needTC) ?  info.TCSum + TCIncSwapOp(job, source1, source2, target1, target2) : -1;
+    double newTCSum            = (needTC) ?  info.TCSum + TCIncSwapOp(job, source1, source2, target1, target2) : -1;
     double newSquaredAligEdges = (needSquaredAligEdges) ? info.squaredAligEdges + squaredAligEdgesIncSwapOp(job, source1, source2, target1, target2) : -1;
     double newWecSum           = (needWec) ?  info.wecSum + WECIncSwapOp(job, source1, source2, target1, target2) : -1;
     double newEwecSum          = (needEwec) ?  info.ewecSum + EWECIncSwapOp(job, source1, source2, target1, target2) : -1;
     double newNcSum            = (needNC) ? info.ncSum + ncIncSwapOp(job, source1, source2, target1, target2) : -1;
     double newLocalScoreSum    = (needLocal) ? info.localScoreSum + localScoreSumIncSwapOp(job, sims, source1, source2, target1, target2) : -1;   
 
-    map<string, double> newLocalScoreSumMap;
-    if (needLocal) {
-        newLocalScoreSumMap = map<string, double>(*info.localScoreSumMap);
-        for (auto &item : newLocalScoreSumMap)
-            item.second += localScoreSumIncSwapOp(localSimMatrixMap[item.first], source1, source2, target1, target2);
-    }
-
     double newCurrentScore = 0;
     bool makeChange = scoreComparison(job, newAligEdges, info.inducedEdges, newTCSum, newLocalScoreSum, newWecSum, newNcSum, newCurrentScore, newEwecSum, newSquaredAligEdges);
     if (makeChange) {
@@ -2724,8 +3178,6 @@ void SANA::performSwap(Job &job, int type) {
         info.ncSum               = newNcSum;
         info.currentScore        = newCurrentScore;
         info.squaredAligEdges    = newSquaredAligEdges;
-        if (needLocal)
-            (*info.localScoreSumMap) = newLocalScoreSumMap;
 #if 0
         if (randomReal(job.gen) <= 1) {
             double foo = eval(*A);
@@ -2914,8 +3366,6 @@ void SANA::releaseAlignment(Job &job) {
     delete info.unassignedNodesG2;
     delete info.unassignedmiRNAsG2;
     delete info.unassignedgenesG2;
-    if (needLocal) 
-        delete info.localScoreSumMap;
 }
 
 double SANA::trueAcceptingProbability(Job &job) {
@@ -2957,7 +3407,6 @@ void SANA::storeAlignment(Job &job) {
     if(needInducedEdges)         storedInducedEdges[A]     = info.inducedEdges;
     if(needTC)                   storedTCSum[A]            = info.TCSum;
     if(needLocal)                storedLocalScoreSum[A]    = info.localScoreSum;
-    if(needLocal)                storedLocalScoreSumMap[A] = info.localScoreSumMap;
     if(needWec)                  storedWecSum[A]           = info.wecSum;
     if(needEwec)                 storedEwecSum[A]          = info.ewecSum;
     if(needNC)                   storedNcSum[A]            = info.ncSum;
@@ -2972,7 +3421,6 @@ void SANA::copyAlignmentFromStorage(Job &job, vector<uint> *A) {
     info.inducedEdges     = (needInducedEdges) ?  storedInducedEdges[A] : -1;
     info.TCSum            = (needTC) ?  storedTCSum[A] : -1;
     info.localScoreSum    = (needLocal) ? storedLocalScoreSum[A] : -1;
-    info.localScoreSumMap = (needLocal) ? new map<string, double>(*storedLocalScoreSumMap[A]) : nullptr;
     info.wecSum           = (needWec) ?  storedWecSum[A] : -1;
     info.ewecSum          = (needEwec) ?  storedEwecSum[A] : -1;
     info.ncSum            = (needNC) ? storedNcSum[A] : -1;
@@ -3053,7 +3501,7 @@ void SANA::trackProgress(Job &job) {
     }
     if (checkScores) {
         double realScore = eval(Al);
-        if (fabs(realScore-info.currentScore) > 0.000001) {
+        if (fabs(realScore-info.currentScore) > 0.000001 + localQuantizationError) {
             cerr << "internal error: incrementally computed score (" << info.currentScore;
             cerr << ") is not correct (" << realScore << ")" << endl;
             info.currentScore = realScore;
@@ -3144,31 +3592,10 @@ int SANA::inducedEdgesIncChangeOp(Job &job, uint source, uint oldTarget, uint ne
 }
     
 double SANA::TCIncChangeOp(Job &job, uint source, uint oldTarget, uint newTarget) {
-    vector<uint> *A = job.info.A;
-    double deltaTriangles = 0;
-    const uint n = G1AdjLists[source].size();
-    uint neighbor1, neighbor2;
-    for(uint i = 0; i < n; ++i){
-        for(uint j = i+1; j < n; ++j){
-            neighbor1 = G1AdjLists[source][i];
-            neighbor2 = G1AdjLists[source][j];
-            if(G1Matrix[neighbor1][neighbor2]){
-                //G1 has a triangle
-                if(G2Matrix[oldTarget][(*A)[neighbor1]] and G2Matrix[oldTarget][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]]){
-                    //G2 HAD a triangle
-                    deltaTriangles -= 1;
-                }
-                if(G2Matrix[newTarget][(*A)[neighbor1]] and G2Matrix[newTarget][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]]){
-                    //G2 GAINS a triangle
-                    deltaTriangles += 1;
-                }
-            }
-        }
-    }
-    return ((double)deltaTriangles/maxTriangles);
+    return ((double)trianglesIncChangeOp(*job.info.A, source, oldTarget, newTarget)/maxTriangles);
 }
 
-double SANA::localScoreSumIncChangeOp(Job &job, vector<vector<float> > const & sim, uint const & source, uint const & oldTarget, uint const & newTarget) {
+double SANA::localScoreSumIncChangeOp(Job &job, SimMatrix const & sim, uint const & source, uint const & oldTarget, uint const & newTarget) {
     return sim[source][newTarget] - sim[source][oldTarget];
 }
 
@@ -3198,19 +3625,7 @@ double SANA::EWECIncChangeOp(Job &job, uint source, uint oldTarget, uint newTarg
 }
 
 double SANA::EWECSimCombo(Job &job, uint source, uint target) {
-    vector<uint> *A = job.info.A;
-    double score = 0;
-    const uint n = G1AdjLists[source].size();
-    uint neighbor;
-    for (uint i = 0; i < n; ++i) {
-        neighbor = G1AdjLists[source][i];
-        if (G2Matrix[target][(*A)[neighbor]]) {
-            int e1 = ewec->getRowIndex(source, neighbor);
-            int e2 = ewec->getColIndex(target, (*A)[neighbor]);
-            score+=ewec->getScore(e2,e1);
-        }
-    }
-    return score/(2*g1Edges);
+    return ewec->simCombo(*job.info.A, source, target)/(2*g1Edges);
 }
 
 int SANA::ncIncChangeOp(Job &job, uint source, uint oldTarget, uint newTarget) {
@@ -3329,51 +3744,8 @@ int SANA::aligEdgesIncSwapOp(Job &job, uint source1, uint source2, uint target1,
 }
 double SANA::TCIncSwapOp(Job &job, uint source1, uint source2, uint target1, uint target2) {
     vector<uint> *A = job.info.A;
-
-    double deltaTriangles = 0;
-    const uint n = G1AdjLists[source1].size();
-    uint neighbor1, neighbor2;
-    for(uint i = 0; i < n; ++i){
-        for(uint j = i+1; j < n; ++j){
-            neighbor1 = G1AdjLists[source1][i];
-            neighbor2 = G1AdjLists[source1][j];
-            if(G1Matrix[neighbor1][neighbor2]){
-                //G1 has a triangle
-                if(G2Matrix[target1][(*A)[neighbor1]] and G2Matrix[target1][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]]){
-                    //G2 HAD a triangle
-                    deltaTriangles -= 1;
-                }
-
-                if((G2Matrix[target2][(*A)[neighbor1]] and G2Matrix[target2][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]])
-                || (neighbor1 == source2 and G2Matrix[target2][target1] and G2Matrix[target2][(*A)[neighbor2]] and G2Matrix[target1][(*A)[neighbor2]])
-                || (neighbor2 == source2 and G2Matrix[target2][(*A)[neighbor1]] and G2Matrix[target2][target1] and G2Matrix[(*A)[neighbor1]][target1])) {
-                    //G2 GAINS a triangle
-                    deltaTriangles += 1;
-                }
-            }
-         }
-    }
-    const uint m = G1AdjLists[source2].size();
-    for(uint i = 0; i < m; ++i){
-        for(uint j = i+1; j < m; ++j){
-            neighbor1 = G1AdjLists[source2][i];
-            neighbor2 = G1AdjLists[source2][j];
-            if(G1Matrix[neighbor1][neighbor2]){
-                //G1 has a triangle
-                if(G2Matrix[target2][(*A)[neighbor1]] and G2Matrix[target2][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]]){
-                    //G2 HAD a triangle
-                    deltaTriangles -= 1;
-                }
-                
-                if((G2Matrix[target1][(*A)[neighbor1]] and G2Matrix[target1][(*A)[neighbor2]] and G2Matrix[(*A)[neighbor1]][(*A)[neighbor2]])
-                   || (neighbor1 == source1 and G2Matrix[target1][target2] and G2Matrix[target1][(*A)[neighbor2]] and G2Matrix[target2][(*A)[neighbor2]])
-                   || (neighbor2 == source1 and G2Matrix[target1][(*A)[neighbor1]] and G2Matrix[target1][target2] and G2Matrix[(*A)[neighbor1]][target2])){
-                    //G2 GAINS a triangle
-                    deltaTriangles += 1;
-                }
-            }
-        }    
-    }
+    int deltaTriangles = trianglesIncSwapOp(*A, source1, source2, target1, target2)
+                       + trianglesIncSwapOp(*A, source2, source1, target2, target1);
     return ((double)deltaTriangles/maxTriangles);
 }
 
@@ -3470,7 +3842,7 @@ int SANA::ncIncSwapOp(Job &job, uint source1, uint source2, uint target1, uint t
     return change;
 }
 
-double SANA::localScoreSumIncSwapOp(Job &job, vector<vector<float> > const & sim, uint const & source1, uint const & source2, uint const & target1, uint const & target2) {
+double SANA::localScoreSumIncSwapOp(Job &job, SimMatrix const & sim, uint const & source1, uint const & source2, uint const & target1, uint const & target2) {
     return sim[source1][target2] - sim[source1][target1] + sim[source2][target1] - sim[source2][target2];
 }
 
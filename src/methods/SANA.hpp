@@ -7,12 +7,16 @@
 #include <chrono>
 #include <ctime>
 #include <random>
+#include <memory>
+#include <functional>
 #include "../measures/localMeasures/LocalMeasure.hpp"
 #include "../measures/Measure.hpp"
 #include "../measures/MeasureCombination.hpp"
 #include "../utils/randomSeed.hpp"
 #include "../utils/ParetoFront.hpp"
 #include "../measures/ExternalWeightedEdgeConservation.hpp"
+#include "../measures/ShortestPathConservation.hpp"
+#include "../measures/LargestCommonConnectedSubgraph.hpp"
 
 #ifdef MULTI_PAIRWISE
 #define PARAMS int aligEdges, int g1Edges, int inducedEdges, int g2Edges, double TCSum, int localScoreSum, int n1, double wecSum, double ewecSum, int ncSum, unsigned int trueA_back, double g1WeightedEdges, double g2WeightedEdges, int squaredAligEdges
@@ -61,6 +65,9 @@ public:
     //set temperature decay dynamically
     void setDynamicTDecay();
 
+    //run this many independent annealing chains in parallel and keep the best
+    void setNumThreads(uint numThreads);
+
     double simpleSearchTInitial();
 
     double elapsedEstimate = 0;
@@ -87,6 +94,20 @@ public:
     double getTInitial(void), getTFinal(void), getTDecay(void);
 
 private:
+    friend class ParallelTempering; //drives SANA iterations of several copies at fixed temperatures
+
+    //data that copies of this object (the chains of a multi-threaded run)
+    //share instead of duplicating; all of it is read-only during a run
+    struct SharedData {
+        Matrix<MATRIX_UNIT> G1Matrix;
+        Matrix<MATRIX_UNIT> G2Matrix;
+        vector<vector<uint> > G1AdjLists;
+        vector<vector<uint> > G2AdjLists;
+        vector<vector<uint> > G1TriangleLists;
+        mutex jobMutex;
+    };
+    shared_ptr<SharedData> shared;
+
     int maxTriangles = 0;
 
     //Temperature Boundaries. Use these after the tinitial has been determined
@@ -102,10 +123,10 @@ private:
     double g2WeightedEdges;
 #endif
     double g2Edges; //stored as double because it appears in division
-    Matrix<MATRIX_UNIT> G1Matrix;
-    Matrix<MATRIX_UNIT> G2Matrix;
-    vector<vector<uint> > G1AdjLists;
-    vector<vector<uint> > G2AdjLists;
+    Matrix<MATRIX_UNIT>& G1Matrix;
+    Matrix<MATRIX_UNIT>& G2Matrix;
+    vector<vector<uint> >& G1AdjLists;
+    vector<vector<uint> >& G2AdjLists;
 
     void initTau(void);
     vector<uint> unLockedNodesG1;
@@ -177,7 +198,7 @@ private:
     //objective function
     MeasureCombination* MC;
     double eval(const Alignment& A);
-    bool scoreComparison(double newAligEdges, double newInducedEdges, double newTCSum, double newLocalScoreSum, double newWecSum, double newNcSum, double& newCurrentScore, double newEwecSum, double newSquaredAligEdges);
+    bool scoreComparison(double newAligEdges, double newInducedEdges, double newTCSum, double newLocalScoreSum, double newWecSum, double newNcSum, double& newCurrentScore, double newEwecSum, double newSquaredAligEdges, double newSpcSum, double newLccsSize);
     double ecWeight;
     double s3Weight;
     double icsWeight;
@@ -189,6 +210,8 @@ private:
     double sesWeight;
     double ewecWeight;
     double TCWeight;
+    double spcWeight;
+    double lccsnWeight;
 
     enum class Score{sum, product, inverse, max, min, maxFactor, pareto};
     Score score;
@@ -213,6 +236,16 @@ private:
     vector<double> candidatesScores;
     //functions
     Alignment runRestartPhases();
+
+    //independent chains (-threads)
+    uint numThreads = 1;
+    uint chainId = 0; //only chain 0 prints progress
+    vector<uint> chainSeeds;
+    vector<double> chainScores;
+    uint bestChain = 0;
+    Alignment runIndependentChains();
+    //false if a weighted measure of MC cannot be evaluated by several chains at once
+    bool measuresAreThreadSafe();
     uint getLowestIndex() const;
     uint getHighestIndex() const;
 
@@ -242,6 +275,12 @@ private:
     double TCSum;
     double TCIncChangeOp(uint source, uint oldTarget, uint newTarget);
     double TCIncSwapOp(uint source1, uint source2, uint target1, uint target2);
+    //for each G1 node u, the pairs of neighbors v < w of u that are adjacent,
+    //stored flat (v0 w0 v1 w1 ...), so a move only visits the G1 triangles it touches
+    vector<vector<uint> >& G1TriangleLists;
+    void initG1TriangleLists();
+    int trianglesIncChangeOp(const vector<uint>& A, uint source, uint oldTarget, uint newTarget);
+    int trianglesIncSwapOp(const vector<uint>& A, uint source, uint other, uint target, uint otherTarget);
 
     //to evaluate nc incrementally
     bool needNC;
@@ -253,7 +292,7 @@ private:
     //to evaluate wec incrementally
     bool needWec;
     double wecSum;
-    vector<vector<float> > wecSims;
+    const SimMatrix& wecSims; //owned by the node similarity measure of wec
     double WECIncChangeOp(uint source, uint oldTarget, uint newTarget);
     double WECIncSwapOp(uint source1, uint source2, uint target1, uint target2);
 
@@ -265,20 +304,44 @@ private:
     double EWECIncSwapOp(uint source1, uint source2, uint target1, uint target2);
     double EWECSimCombo(uint source, uint target);
 
+    //to evaluate spc incrementally (only with the sum score)
+    bool needSpc;
+    ShortestPathConservation* spc;
+    double spcSum; //the distanceDifferenceSum of A
+
+    //to evaluate lccsn incrementally (only with the sum score)
+    bool needLccs;
+    shared_ptr<LargestCommonConnectedSubgraph> lccs; //its own tracker, see initDataStructures
+    uint lccsSize; //nodes in the largest common connected subgraph of A
+
+    //EC, SES and WEC all walk the G1 neighborhood of the moved nodes and look up
+    //their images in G2Matrix. When more than one of them is needed, the walk is
+    //done once and all the increments are computed from the same loads.
+    struct EdgeIncs {
+        int aligEdges = 0;
+        int squaredAligEdges = 0;
+        double wec = 0;
+    };
+    bool fuseEdgeIncs;
+    EdgeIncs edgeIncChangeOp(uint source, uint oldTarget, uint newTarget);
+    EdgeIncs edgeIncSwapOp(uint source1, uint source2, uint target1, uint target2);
+    template <bool ses, bool wec> void edgeIncNeighborhood(uint source, uint oldTarget, uint newTarget, EdgeIncs& incs);
+    template <bool ses, bool wec> void edgeIncSwapOp(uint source1, uint source2, uint target1, uint target2, EdgeIncs& incs);
+
     //to evaluate local measures incrementally
     bool needLocal;
     double localScoreSum;
-    map<string, double>* localScoreSumMap;
-    vector<vector<float> > sims;
+    void sumLocalScores();
+    double localQuantizationError = 0; //score tolerance for quantized sims, see initDataStructures
+    const SimMatrix& sims; //owned by MC
 #ifdef CORES
     Matrix<ulong> coreFreq;
     vector<ulong> coreCount; // number of times this node in g1 was sampled.
     Matrix<double> weightedCoreFreq; // weighted by pBad below
     vector<double> totalCoreWeight; // sum of all pBads, for each node in G1.
 #endif
-    map<string, vector<vector<float> > > localSimMatrixMap;
-    double localScoreSumIncChangeOp(vector<vector<float> > const & sim, uint const & source, uint const & oldTarget, uint const & newTarget);
-    double localScoreSumIncSwapOp(vector<vector<float> > const & sim, uint const & source1, uint const & source2, uint const & target1, uint const & target2);
+    double localScoreSumIncChangeOp(SimMatrix const & sim, uint const & source, uint const & oldTarget, uint const & newTarget);
+    double localScoreSumIncSwapOp(SimMatrix const & sim, uint const & source1, uint const & source2, uint const & target1, uint const & target2);
 
 
 
@@ -309,6 +372,21 @@ private:
     void performChange(int type);
     void performSwap(int type);
 
+    //Specialized iteration kernels. The common objectives (EC, S3, sequence or
+    //graphlet sims, SES) get their own instantiation so that the hot path has no
+    //need* branches and no math for weights that are zero. Anything else (other
+    //measures, score types, node types, CORES) runs genericSANAIteration.
+    enum KernelMeasure { kernelEC = 1, kernelS3 = 2, kernelLocal = 4, kernelSES = 8 };
+    void (SANA::*iterationKernel)() = &SANA::genericSANAIteration;
+    string iterationKernelName = "generic";
+    void selectIterationKernel();
+    void genericSANAIteration();
+    template <uint measures> void kernelSANAIteration();
+    template <uint measures> void kernelPerformChange();
+    template <uint measures> void kernelPerformSwap();
+    template <uint measures> bool kernelScoreComparison(double newAligEdges, double newInducedEdges,
+        double newLocalScoreSum, double newSquaredAligEdges, double& newCurrentScore);
+
 
     //others
     Timer timer;
@@ -319,6 +397,19 @@ private:
     bool implementsLocking(){ return true; }
 
     double pForTInitial(double TInitial);
+    double pForTInitial(double TInitial, const Alignment& startA);
+    //pForTInitial of each temperature. The probes are independent, so they
+    //run concurrently on copies of this object, which share its iteration
+    //speed calibration. scores, if given, gets the score each probe ends with.
+    vector<double> pForTInitials(const vector<double>& temperatures, vector<double>* scores = nullptr);
+    uint numProbeThreads();
+    //probes 10^e for e = start, start+step, ... (as many at a time as there are
+    //probe threads) until stop(pBad), printing each probe; returns the last e
+    int scanTemperatureExponents(int start, int step, const function<bool(double)>& stop, const string& label);
+    //4 bisection steps on the log10 temperature between left and right: the
+    //right end moves down when pBad > tooHigh and the left end up when pBad < tooLow
+    void bisectTemperatures(double left, double right, double tooHigh, double tooLow,
+        const vector<Alignment>& startAligs, vector<double>& logTemps, vector<double>& pBads, vector<double>& scores);
     double getPforTInitial(const Alignment& startA, double maxExecutionSeconds,
         long long int& iter);
     string getFolder();
@@ -365,7 +456,6 @@ private:
     unordered_map<vector<uint>*, int> storedNcSum;
     unordered_map<vector<uint>*, double> storedTCSum;
     unordered_map<vector<uint>*, double> storedCurrentScore;
-    unordered_map<vector<uint>*, map<string, double>*> storedLocalScoreSumMap;
     typedef double (*calc)(PARAMS);
     unordered_map<string, calc> measureCalculation;
     unordered_set<string> localScoreNames = { "edgec", "edged", "esim", "go", "graphlet",
@@ -383,7 +473,6 @@ private:
         vector<uint> *unassignedNodesG2;
         vector<uint> *unassignedmiRNAsG2;
         vector<uint> *unassignedgenesG2;
-        map<string, double> *localScoreSumMap;
         int aligEdges;
         int squaredAligEdges;
         int inducedEdges;
@@ -445,7 +534,7 @@ private:
     int squaredAligEdgesIncChangeOp(Job &job, uint source, uint oldTarget, uint newTarget);
     int inducedEdgesIncChangeOp(Job &job, uint source, uint oldTarget, uint newTarget);
     double TCIncChangeOp(Job &job, uint source, uint oldTarget, uint newTarget);
-    double localScoreSumIncChangeOp(Job &job, vector<vector<float> > const & sim, uint const & source, uint const & oldTarget, uint const & newTarget);
+    double localScoreSumIncChangeOp(Job &job, SimMatrix const & sim, uint const & source, uint const & oldTarget, uint const & newTarget);
     double WECIncChangeOp(Job &job, uint source, uint oldTarget, uint newTarget);
     double EWECSimCombo(Job &job, uint source, uint target);
     double EWECIncChangeOp(Job &job, uint source, uint oldTarget, uint newTarget);
@@ -457,7 +546,7 @@ private:
     double WECIncSwapOp(Job &job, uint source1, uint source2, uint target1, uint target2);
     double EWECIncSwapOp(Job &job, uint source1, uint source2, uint target1, uint target2);
     int ncIncSwapOp(Job &job, uint source1, uint source2, uint target1, uint target2);
-    double localScoreSumIncSwapOp(Job &job, vector<vector<float> > const & sim, uint const & source1, uint const & source2, uint const & target1, uint const & target2);
+    double localScoreSumIncSwapOp(Job &job, SimMatrix const & sim, uint const & source1, uint const & source2, uint const & target1, uint const & target2);
 
 
     bool scoreComparison(Job &job, double newAligEdges, double newInducedEdges, double newTCSum, 
@@ -470,7 +559,7 @@ private:
 
     long long int sharedIter = 0;
     long long int iterOfLastTrackProgress = 0;
-    mutex getJobMutex;
+    mutex& getJobMutex;
 
 
     chrono::steady_clock::time_point startTime;
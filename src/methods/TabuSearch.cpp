@@ -85,18 +85,12 @@ TabuSearch::TabuSearch(Graph* G1, Graph* G2,
     if (needWec) {
         Measure* wec = MC->getMeasure("wec");
         LocalMeasure* m = ((WeightedEdgeConservation*) wec)->getNodeSimMeasure();
-        vector<vector<float> >* wecSimsP = m->getSimMatrix();
-        wecSims = vector<vector<float> > (n1, vector<float> (n2, 0));
-        for (uint i = 0; i < n1; i++) {
-            for (uint j = 0; j < n2; j++) {
-                wecSims[i][j] = (*wecSimsP)[i][j];
-            }
-        }
+        wecSims = m->getSimMatrix();
     }
 
     //to evaluate local measures incrementally
     needLocal = localWeight > 0;
-    if (needLocal) sims = MC->getAggregatedLocalSims();
+    if (needLocal) sims = &MC->getAggregatedLocalSims();
 
     //other execution options
     enableTrackProgress = true;
@@ -162,14 +156,14 @@ void TabuSearch::initDataStructures(const Alignment& startA) {
     if (needLocal) {
         localScoreSum = 0;
         for (uint i = 0; i < n1; i++) {
-            localScoreSum += sims[i][A[i]];
+            localScoreSum += (*sims)[i][A[i]];
         }
     }
 
     if (needWec) {
         wecSum = 0;
         for (uint i = 0; i < n1; i++) {
-            wecSum += wecSims[i][A[i]];
+            wecSum += (*wecSims)[i][A[i]];
         }
     }
 
@@ -465,14 +459,14 @@ int TabuSearch::inducedEdgesIncChangeOp(uint source, uint oldTarget, uint newTar
 }
 
 double TabuSearch::localScoreSumIncChangeOp(uint source, uint oldTarget, uint newTarget) {
-    return sims[source][newTarget] - sims[source][oldTarget];
+    return (*sims)[source][newTarget] - (*sims)[source][oldTarget];
 }
 
 double TabuSearch::localScoreSumIncSwapOp(uint source1, uint source2, uint target1, uint target2) {
-    return sims[source1][target2] -
-           sims[source1][target1] +
-           sims[source2][target1] -
-           sims[source2][target2];
+    return (*sims)[source1][target2] -
+           (*sims)[source1][target1] +
+           (*sims)[source2][target1] -
+           (*sims)[source2][target2];
 }
 
 double TabuSearch::WECIncChangeOp(uint source, uint oldTarget, uint newTarget) {
@@ -480,12 +474,12 @@ double TabuSearch::WECIncChangeOp(uint source, uint oldTarget, uint newTarget) {
     for (uint j = 0; j < G1AdjLists[source].size(); j++) {
         uint neighbor = G1AdjLists[source][j];
         if (G2Matrix[oldTarget][A[neighbor]]) {
-            res -= wecSims[source][oldTarget];
-            res -= wecSims[neighbor][A[neighbor]];
+            res -= (*wecSims)[source][oldTarget];
+            res -= (*wecSims)[neighbor][A[neighbor]];
         }
         if (G2Matrix[newTarget][A[neighbor]]) {
-            res += wecSims[source][newTarget];
-            res += wecSims[neighbor][A[neighbor]];
+            res += (*wecSims)[source][newTarget];
+            res += (*wecSims)[neighbor][A[neighbor]];
         }
     }
     return res;
@@ -496,23 +490,23 @@ double TabuSearch::WECIncSwapOp(uint source1, uint source2, uint target1, uint t
     for (uint j = 0; j < G1AdjLists[source1].size(); j++) {
         uint neighbor = G1AdjLists[source1][j];
         if (G2Matrix[target1][A[neighbor]]) {
-            res -= wecSims[source1][target1];
-            res -= wecSims[neighbor][A[neighbor]];
+            res -= (*wecSims)[source1][target1];
+            res -= (*wecSims)[neighbor][A[neighbor]];
         }
         if (G2Matrix[target2][A[neighbor]]) {
-            res += wecSims[source1][target2];
-            res += wecSims[neighbor][A[neighbor]];
+            res += (*wecSims)[source1][target2];
+            res += (*wecSims)[neighbor][A[neighbor]];
         }
     }
     for (uint j = 0; j < G1AdjLists[source2].size(); j++) {
         uint neighbor = G1AdjLists[source2][j];
         if (G2Matrix[target2][A[neighbor]]) {
-            res -= wecSims[source2][target2];
-            res -= wecSims[neighbor][A[neighbor]];
+            res -= (*wecSims)[source2][target2];
+            res -= (*wecSims)[neighbor][A[neighbor]];
         }
         if (G2Matrix[target1][A[neighbor]]) {
-            res += wecSims[source2][target1];
-            res += wecSims[neighbor][A[neighbor]];
+            res += (*wecSims)[source2][target1];
+            res += (*wecSims)[neighbor][A[neighbor]];
         }
     }
     //address case swapping between adjacent nodes with adjacent images:
@@ -522,8 +516,8 @@ double TabuSearch::WECIncSwapOp(uint source1, uint source2, uint target1, uint t
 #else
     if (G1Matrix[source1][source2] and G2Matrix[target1][target2]) {
 #endif
-        res += 2*wecSims[source1][target1];
-        res += 2*wecSims[source2][target2];
+        res += 2*(*wecSims)[source1][target1];
+        res += 2*(*wecSims)[source2][target2];
     }
     return res;
 }
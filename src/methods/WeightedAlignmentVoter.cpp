@@ -59,7 +59,7 @@ Alignment WeightedAlignmentVoter::run() {
     vector<vector<double> > simMatrix(n1, vector<double> (n2));
     for (int i = 0; i < n1; i++) {
         for (int j = 0; j < n2; j++) {
-            nodeSimMatrix[i][j] = (*(nodeSim->getSimMatrix()))[i][j];
+            nodeSimMatrix[i][j] = nodeSim->getSimMatrix()->get(i, j);
             simMatrix[i][j] = nodeSimMatrix[i][j];
         }
     }
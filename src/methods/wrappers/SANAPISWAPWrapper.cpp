@@ -2,11 +2,10 @@
 
 using namespace std;
 
-SANAPISWAPWrapper::SANAPISWAPWrapper(Graph* G1, Graph* G2, ArgumentParser args, MeasureCombination M): WrappedMethod(G1, G2, "SANAPISWAP", args.strings["-wrappedArgs"]){
+SANAPISWAPWrapper::SANAPISWAPWrapper(Graph* G1, Graph* G2, ArgumentParser args, MeasureCombination& M): WrappedMethod(G1, G2, "SANAPISWAP", args.strings["-wrappedArgs"]), M(M) {
     wrappedDir = "wrappedAlgorithms/PISWAP";
     Graph1 = G1;
     Graph2 = G2;
-    this->M = M;
     sanaMethod = (SANA*)(initSANA(*G1, *G2, args, this->M));
     
     string outfile = args.strings["-o"];
@@ -15,7 +15,7 @@ using namespace std;
 
 class SANAPISWAPWrapper: public WrappedMethod {
 public:
-    SANAPISWAPWrapper(Graph* G1, Graph* G2, ArgumentParser args, MeasureCombination M);
+    SANAPISWAPWrapper(Graph* G1, Graph* G2, ArgumentParser args, MeasureCombination& M);
     Alignment run();
 
 private:
@@ -24,7 +24,7 @@ private:
 
     Graph* Graph1;
     Graph* Graph2;
-    MeasureCombination M;
+    MeasureCombination& M;
 
     void loadDefaultParameters();
     string convertAndSaveGraph(Graph* graph, string name);
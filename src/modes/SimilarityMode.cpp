@@ -2,6 +2,7 @@
 #include "SimilarityMode.hpp"
 
 #include "../utils/utils.hpp"
+#include "../utils/SimMatrixFile.hpp"
 
 #include "../arguments/measureSelector.hpp"
 #include "../arguments/methodSelector.hpp"
@@ -20,41 +21,23 @@ void SimilarityMode::run(ArgumentParser& args) {
         exit(-1);
     }
 
-    vector<vector <float> > sim = M.getAggregatedLocalSims();
+    const SimMatrix& sim = M.getAggregatedLocalSims();
 
-    saveSimilarityMatrix(sim, G1, G2, args.strings["-o"] + ".sim", args.doubles["-simFormat"]);
+    //-simFormat is also the list of formats of the -simFile files; here it is one value
+    const vector<double>& formats = args.doubleVectors["-simFormat"];
+    int format = formats.empty() ? 0 : formats[0];
+    saveSimilarityMatrix(sim, G1, G2, args.strings["-o"] + ".sim", format, args.doubles["-simTopK"]);
 
     cout << "Finished. Saved similarity file as " << (args.strings["-o"] + ".sim") << endl;
 }
 
-void SimilarityMode::saveSimilarityMatrix(vector<vector <float> > sim, Graph &G1, Graph &G2, string file, int format) {
-    ofstream outfile;
-    outfile.open(file.c_str());
-
-    if (not outfile.is_open()) {
-        cout << "Problem saving similarity to specified location. Saving to sana program file." << endl;
-        exit(-1);
-    }
-
-    switch(format) {
-        case 0:
-            for(uint i = 0; i < sim.size(); ++i) {
-                for(uint j = 0; j < sim[i].size(); ++j) {
-                    outfile << i << " " << j << " " << sim[i][j] << endl;
-                }
-            }
-        break;
-        case 1:
-            unordered_map<uint,string> g1Map = G1.getIndexToNodeNameMap();
-            unordered_map<uint,string>  g2Map = G2.getIndexToNodeNameMap();
-            for(uint i = 0; i < sim.size(); ++i) {
-                for(uint j = 0; j < sim[i].size(); ++j) {
-                    outfile << g1Map[i] << " " << g2Map[j] << " " << sim[i][j] << endl;
-                }
-            }
-        break;
+void SimilarityMode::saveSimilarityMatrix(const SimMatrix& sim, Graph &G1, Graph &G2, string file, int format, uint topK) {
+    vector<string> names1, names2;
+    if (format == SimMatrixFile::NAMES) {
+        names1 = G1.getNodeNames();
+        names2 = G2.getNodeNames();
     }
-    outfile.close();
+    SimMatrixFile::write(sim, file, format, names1, names2, topK);
 }
 
 string SimilarityMode::getName(void) {
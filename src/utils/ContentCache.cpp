@@ -0,0 +1,71 @@
+#include "ContentCache.hpp"
+#include "utils.hpp"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+
+using namespace std;
+
+string ContentCache::folder = "";
+
+void ContentCache::setFolder(const string& folder) {
+    ContentCache::folder = folder;
+    if (folder != "") {
+        if (ContentCache::folder.back() != '/') ContentCache::folder += '/';
+        createFolder(ContentCache::folder);
+    }
+}
+
+bool ContentCache::isEnabled() {
+    return folder != "";
+}
+
+uint64_t ContentCache::hash(uint64_t h, uint64_t value) {
+    //splitmix64 finalizer of the combination
+    uint64_t x = h ^ (value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+uint64_t ContentCache::hash(uint64_t h, const string& s) {
+    uint64_t fnv = 0xcbf29ce484222325ULL;
+    for (unsigned char c : s) {
+        fnv = (fnv ^ c) * 0x100000001b3ULL;
+    }
+    return hash(hash(h, s.size()), fnv);
+}
+
+string ContentCache::entryFileName(const string& kind, uint64_t key) {
+    ostringstream oss;
+    oss << folder << kind << "_" << hex << setw(16) << setfill('0') << key << ".bin";
+    return oss.str();
+}
+
+void ContentCache::store(const string& entryFileName, const function<void(const string&)>& write) {
+    //the lock file is never removed, so that a lock cannot be taken on a file
+    //that is being deleted; a process that dies releases its lock
+    string lockName = entryFileName + ".lock";
+    int fd = open(lockName.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd == -1) return;
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        close(fd);
+        return;
+    }
+    string tmpName = entryFileName + "." + to_string(getpid()) + ".tmp";
+    try {
+        write(tmpName);
+        if (rename(tmpName.c_str(), entryFileName.c_str()) != 0) {
+            remove(tmpName.c_str());
+        }
+    } catch (const runtime_error& e) {
+        cerr << "Warning: could not write cache entry " << entryFileName << ": " << e.what() << endl;
+        remove(tmpName.c_str());
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+}
@@ -0,0 +1,45 @@
+#ifndef CONTENTCACHE_HPP
+#define CONTENTCACHE_HPP
+
+#include <string>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+/*
+Folder of files holding expensive results (similarity matrices, graphlet
+degree vectors) named after a hash of everything they were computed from,
+so a result is reused whenever the same graphs and parameters come back,
+under whatever names, and never when a graph has changed. The entries are
+FlatBinary files, so they are loaded by mapping them.
+
+Several SANA processes can share the folder: an entry is written to a
+temporary file by the process holding its lock and then renamed into place,
+so readers only ever see complete entries.
+
+The cache is off until a folder is set (-cacheDir).
+*/
+class ContentCache {
+public:
+    //"" disables the cache
+    static void setFolder(const string& folder);
+    static bool isEnabled();
+
+    //to build keys: h = hash(hash(hash(0, a), b), c)...
+    static uint64_t hash(uint64_t h, uint64_t value);
+    static uint64_t hash(uint64_t h, const string& s);
+
+    //file of the entry of the given kind (e.g. "sim", "gdv") and key
+    static string entryFileName(const string& kind, uint64_t key);
+
+    //calls write(tmpFileName) and renames the file to entryFileName. Does
+    //nothing if another process is writing the same entry; a failed write
+    //only leaves the entry missing.
+    static void store(const string& entryFileName, const function<void(const string&)>& write);
+
+private:
+    static string folder;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef EDGEHASH_HPP
+#define EDGEHASH_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "cereal/types/vector.hpp"
+
+using namespace std;
+
+/*
+Set of (node1, node2) pairs stored in a single open addressing table with
+linear probing. Memory is O(number of edges) instead of the O(n^2) of a dense
+adjacency matrix, and a lookup is a hash plus (usually) one or two loads from a
+single array, unlike unordered_map which chases a pointer per bucket. Used by
+FlatMatrix<bool> for networks too large for a dense bit matrix.
+*/
+class EdgeHash {
+public:
+    EdgeHash(): count(0) {}
+
+    static uint64_t key(uint node1, uint node2) {
+        return ((uint64_t) node1 << 32) | node2;
+    }
+
+    bool contains(uint64_t k) const {
+        if (slots.empty()) return false;
+        for (size_t i = slot(k); ; i = (i+1) & mask()) {
+            if (slots[i] == k) return true;
+            if (slots[i] == EMPTY) return false;
+        }
+    }
+
+    void insert(uint64_t k) {
+        if (2*(count+1) > slots.size()) grow();
+        size_t i = slot(k);
+        for (; slots[i] != EMPTY; i = (i+1) & mask()) {
+            if (slots[i] == k) return;
+        }
+        slots[i] = k;
+        count++;
+    }
+
+    //backward shift deletion, so no tombstones are needed
+    void erase(uint64_t k) {
+        if (slots.empty()) return;
+        size_t i = slot(k);
+        for (; slots[i] != k; i = (i+1) & mask()) {
+            if (slots[i] == EMPTY) return;
+        }
+        for (size_t j = (i+1) & mask(); slots[j] != EMPTY; j = (j+1) & mask()) {
+            size_t home = slot(slots[j]);
+            //move slots[j] to the hole at i unless its home lies cyclically in (i, j]
+            bool stays = (i <= j) ? (i < home and home <= j) : (i < home or home <= j);
+            if (not stays) {
+                slots[i] = slots[j];
+                i = j;
+            }
+        }
+        slots[i] = EMPTY;
+        count--;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    template <class Archive>
+    void serialize(Archive & archive) {
+        archive(count, slots);
+    }
+
+private:
+    static const uint64_t EMPTY = ~(uint64_t) 0; //never a valid key: node indices are < 2^32-1
+    vector<uint64_t> slots; //size is 0 or a power of 2, at most half full
+    size_t count;
+
+    size_t mask() const {
+        return slots.size() - 1;
+    }
+
+    size_t slot(uint64_t k) const {
+        //splitmix64 finalizer
+        k = (k ^ (k >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        k = (k ^ (k >> 27)) * 0x94d049bb133111ebULL;
+        return (k ^ (k >> 31)) & mask();
+    }
+
+    void grow() {
+        vector<uint64_t> old(slots.size() ? 2*slots.size() : 64, EMPTY);
+        old.swap(slots);
+        count = 0;
+        for (uint64_t k : old) {
+            if (k != EMPTY) insert(k);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "FlatBinary.hpp"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const size_t HEADER_SIZE = 16; //magic, version, flags
+
+FlatBinaryWriter::FlatBinaryWriter(const string& fileName, const char magic[8], uint32_t version, uint32_t flags):
+    ofs(fileName, ofstream::binary | ofstream::out)
+{
+    if (not ofs.is_open()) {
+        throw runtime_error("cannot write binary file " + fileName);
+    }
+    ofs.write(magic, 8);
+    ofs.write((const char*) &version, sizeof(version));
+    ofs.write((const char*) &flags, sizeof(flags));
+}
+
+void FlatBinaryWriter::writeSection(const void* data, uint64_t bytes) {
+    static const char padding[8] = {0};
+    ofs.write((const char*) &bytes, sizeof(bytes));
+    if (bytes > 0) ofs.write((const char*) data, bytes);
+    if (bytes % 8 != 0) ofs.write(padding, 8 - bytes % 8);
+}
+
+void FlatBinaryWriter::writeNestedVector(const vector<vector<uint> >& v) {
+    vector<uint64_t> offsets(v.size()+1, 0);
+    for (uint i = 0; i < v.size(); i++) {
+        offsets[i+1] = offsets[i] + v[i].size();
+    }
+    vector<uint> values;
+    values.reserve(offsets.back());
+    for (const auto& inner : v) {
+        values.insert(values.end(), inner.begin(), inner.end());
+    }
+    writeVector(offsets);
+    writeVector(values);
+}
+
+void FlatBinaryWriter::writeStrings(const vector<string>& v) {
+    vector<uint64_t> offsets(v.size()+1, 0);
+    string chars;
+    for (uint i = 0; i < v.size(); i++) {
+        chars += v[i];
+        offsets[i+1] = chars.size();
+    }
+    writeVector(offsets);
+    writeArray(chars.data(), chars.size());
+}
+
+void FlatBinaryWriter::close() {
+    ofs.close();
+    if (ofs.fail()) {
+        throw runtime_error("error writing binary file");
+    }
+}
+
+FlatBinaryReader::FlatBinaryReader(const string& fileName, const char magic[8], uint32_t version):
+    fileName(fileName), base(nullptr), size(0), offset(HEADER_SIZE)
+{
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw runtime_error("cannot open binary file " + fileName);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 or (size_t) st.st_size < HEADER_SIZE) {
+        ::close(fd);
+        throw runtime_error("corrupt binary file " + fileName);
+    }
+    size = st.st_size;
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        throw runtime_error("cannot map binary file " + fileName);
+    }
+    base = (const char*) p;
+    uint32_t fileVersion;
+    memcpy(&fileVersion, base + 8, sizeof(fileVersion));
+    if (memcmp(base, magic, 8) != 0 or fileVersion != version) {
+        munmap((void*) base, size);
+        throw runtime_error("binary file " + fileName + " has an unknown format or version");
+    }
+}
+
+FlatBinaryReader::~FlatBinaryReader() {
+    munmap((void*) base, size);
+}
+
+bool FlatBinaryReader::isValid(const string& fileName, const char magic[8], uint32_t version) {
+    ifstream ifs(fileName, ifstream::binary | ifstream::in);
+    char header[HEADER_SIZE];
+    if (not ifs.read(header, HEADER_SIZE)) return false;
+    uint32_t fileVersion;
+    memcpy(&fileVersion, header + 8, sizeof(fileVersion));
+    return memcmp(header, magic, 8) == 0 and fileVersion == version;
+}
+
+uint32_t FlatBinaryReader::getFlags() const {
+    uint32_t flags;
+    memcpy(&flags, base + 12, sizeof(flags));
+    return flags;
+}
+
+const char* FlatBinaryReader::nextSection(uint64_t& bytes) {
+    if (offset + sizeof(bytes) > size) {
+        throw runtime_error("truncated binary file " + fileName);
+    }
+    memcpy(&bytes, base + offset, sizeof(bytes));
+    offset += sizeof(bytes);
+    if (bytes > size - offset) {
+        throw runtime_error("truncated binary file " + fileName);
+    }
+    const char* p = base + offset;
+    offset += (bytes + 7) / 8 * 8;
+    return p;
+}
+
+void FlatBinaryReader::checkOffsets(const uint64_t* offsets, uint64_t n, uint64_t total) const {
+    if (n == 0 or offsets[0] != 0 or offsets[n-1] != total) {
+        throw runtime_error("corrupt binary file " + fileName);
+    }
+    for (uint64_t i = 0; i+1 < n; i++) {
+        if (offsets[i] > offsets[i+1]) {
+            throw runtime_error("corrupt binary file " + fileName);
+        }
+    }
+}
+
+vector<vector<uint> > FlatBinaryReader::readNestedVector() {
+    uint64_t n, total;
+    const uint64_t* offsets = readArray<uint64_t>(n);
+    const uint* values = readArray<uint>(total);
+    checkOffsets(offsets, n, total);
+    vector<vector<uint> > v(n-1);
+    for (uint i = 0; i+1 < n; i++) {
+        v[i].assign(values + offsets[i], values + offsets[i+1]);
+    }
+    return v;
+}
+
+vector<string> FlatBinaryReader::readStrings() {
+    uint64_t n, total;
+    const uint64_t* offsets = readArray<uint64_t>(n);
+    const char* chars = readArray<char>(total);
+    checkOffsets(offsets, n, total);
+    vector<string> v(n-1);
+    for (uint i = 0; i+1 < n; i++) {
+        v[i].assign(chars + offsets[i], chars + offsets[i+1]);
+    }
+    return v;
+}
@@ -0,0 +1,109 @@
+#ifndef FLATBINARY_HPP
+#define FLATBINARY_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+/*
+Flat, versioned binary files meant to be memory-mapped instead of parsed.
+A file is an 8-byte magic string, a uint32 format version and a uint32 of
+user flags, followed by sections. Each section is a uint64 byte count and the
+raw bytes of a trivially copyable array, padded to 8 bytes so every array
+starts aligned. A reader gets a pointer straight into the mapping, so loading
+is a page fault per touched page plus, if the caller wants its own
+containers, one memcpy per array.
+*/
+class FlatBinaryWriter {
+public:
+    FlatBinaryWriter(const string& fileName, const char magic[8], uint32_t version, uint32_t flags = 0);
+
+    template <typename T>
+    void writeArray(const T* data, uint64_t count) {
+        writeSection(data, count * sizeof(T));
+    }
+
+    template <typename T>
+    void writeVector(const vector<T>& v) {
+        writeArray(v.data(), v.size());
+    }
+
+    template <typename T>
+    void writeScalar(const T& value) {
+        writeArray(&value, 1);
+    }
+
+    //as two sections: n+1 offsets and the concatenated lists
+    void writeNestedVector(const vector<vector<uint> >& v);
+    //as two sections: n+1 offsets and the concatenated characters
+    void writeStrings(const vector<string>& v);
+
+    void close();
+
+private:
+    ofstream ofs;
+    void writeSection(const void* data, uint64_t bytes);
+};
+
+class FlatBinaryReader {
+public:
+    //throws if the file cannot be mapped or its magic or version differ
+    FlatBinaryReader(const string& fileName, const char magic[8], uint32_t version);
+    ~FlatBinaryReader();
+    FlatBinaryReader(const FlatBinaryReader&) = delete;
+    FlatBinaryReader& operator = (const FlatBinaryReader&) = delete;
+
+    //checks only the header, without mapping the file
+    static bool isValid(const string& fileName, const char magic[8], uint32_t version);
+
+    uint32_t getFlags() const;
+
+    //pointer into the mapping, valid while the reader exists
+    template <typename T>
+    const T* readArray(uint64_t& count) {
+        uint64_t bytes;
+        const char* p = nextSection(bytes);
+        if (bytes % sizeof(T) != 0) {
+            throw runtime_error("corrupt binary file " + fileName);
+        }
+        count = bytes / sizeof(T);
+        return reinterpret_cast<const T*>(p);
+    }
+
+    template <typename T>
+    vector<T> readVector() {
+        uint64_t count;
+        const T* p = readArray<T>(count);
+        return vector<T>(p, p + count);
+    }
+
+    template <typename T>
+    T readScalar() {
+        uint64_t count;
+        const T* p = readArray<T>(count);
+        if (count != 1) {
+            throw runtime_error("corrupt binary file " + fileName);
+        }
+        return *p;
+    }
+
+    vector<vector<uint> > readNestedVector();
+    vector<string> readStrings();
+
+private:
+    string fileName;
+    const char* base;
+    size_t size;
+    size_t offset;
+    const char* nextSection(uint64_t& bytes);
+    //the offsets of n-1 ranges of a section of total elements must start at 0,
+    //never decrease and end at total
+    void checkOffsets(const uint64_t* offsets, uint64_t n, uint64_t total) const;
+};
+
+#endif
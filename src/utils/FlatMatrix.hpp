@@ -0,0 +1,168 @@
+#ifndef FLATMATRIX_HPP
+#define FLATMATRIX_HPP
+
+#include <vector>
+#include <cstdint>
+#include "cereal/types/vector.hpp"
+#include "EdgeHash.hpp"
+
+using namespace std;
+
+/*
+Dense matrix stored in a single contiguous buffer, row-major, with every row
+padded to a whole number of cache lines. Compared to vector<vector<T> > a
+lookup M[i][j] is one multiply-add and one load instead of two dependent
+loads, and rows never straddle a cache line boundary more than necessary.
+
+FlatMatrix<bool> is specialized to store one bit per entry, so the adjacency
+matrix of a 20k node network is ~50MB instead of the ~400MB a byte per entry
+would take, and the rows touched by SANA's inner loop stay much hotter in cache.
+Past FLAT_MATRIX_SPARSE_NODES rows or columns even that is too much (100k nodes
+would take 1.25GB), so the set entries are kept in an EdgeHash instead; the
+choice is made at construction and is invisible to the users of the matrix.
+*/
+
+#define FLAT_MATRIX_CACHE_LINE 64
+#ifndef FLAT_MATRIX_SPARSE_NODES
+#define FLAT_MATRIX_SPARSE_NODES 50000
+#endif
+
+template <typename T>
+class FlatMatrix {
+public:
+    class Row {
+    public:
+        Row(T* p): p(p) {}
+        T& operator [] (uint j) const { return p[j]; }
+    private:
+        T* p;
+    };
+
+    FlatMatrix(): n(0), cols(0), stride(0) {}
+
+    FlatMatrix(uint row, uint col): n(row), cols(col), stride(paddedStride(col)),
+        v((size_t) row * paddedStride(col), T()) {}
+
+    Row operator [] (uint node1) {
+        return Row(&v[(size_t) node1 * stride]);
+    }
+
+    T get(uint node1, uint node2) const {
+        return v[(size_t) node1 * stride + node2];
+    }
+
+    const T* row(uint node1) const {
+        return &v[(size_t) node1 * stride];
+    }
+
+    uint size() const {
+        return n;
+    }
+
+    template <class Archive>
+    void serialize(Archive & archive) {
+        archive(n, cols, stride, v);
+    }
+
+private:
+    uint n, cols, stride;
+    vector<T> v;
+
+    static uint paddedStride(uint col) {
+        const uint perLine = sizeof(T) < FLAT_MATRIX_CACHE_LINE ? FLAT_MATRIX_CACHE_LINE / sizeof(T) : 1;
+        return ((col + perLine - 1) / perLine) * perLine;
+    }
+};
+
+template <>
+class FlatMatrix<bool> {
+public:
+    typedef uint64_t Word;
+    static const uint WORD_BITS = 64;
+
+    //refers to a bit of a dense row (w != nullptr) or to a key of the hash
+    class Reference {
+    public:
+        Reference(Word* w, Word mask): w(w), mask(mask), hash(nullptr) {}
+        Reference(EdgeHash* hash, uint64_t key): w(nullptr), mask(key), hash(hash) {}
+        operator bool() const {
+            return w ? (*w & mask) != 0 : hash->contains(mask);
+        }
+        Reference& operator = (bool value) {
+            if (w) {
+                if (value) *w |= mask;
+                else *w &= ~mask;
+            } else {
+                if (value) hash->insert(mask);
+                else hash->erase(mask);
+            }
+            return *this;
+        }
+        Reference& operator = (const Reference& other) {
+            return *this = (bool) other;
+        }
+    private:
+        Word* w;
+        Word mask; //the key when the matrix is sparse
+        EdgeHash* hash;
+    };
+
+    class Row {
+    public:
+        Row(Word* p): p(p), hash(nullptr), node1(0) {}
+        Row(EdgeHash* hash, uint node1): p(nullptr), hash(hash), node1(node1) {}
+        Reference operator [] (uint j) const {
+            if (p) return Reference(p + j / WORD_BITS, Word(1) << (j % WORD_BITS));
+            return Reference(hash, EdgeHash::key(node1, j));
+        }
+    private:
+        Word* p;
+        EdgeHash* hash;
+        uint node1;
+    };
+
+    FlatMatrix(): n(0), cols(0), stride(0), sparse(false) {}
+
+    FlatMatrix(uint row, uint col): n(row), cols(col),
+        sparse(row >= FLAT_MATRIX_SPARSE_NODES or col >= FLAT_MATRIX_SPARSE_NODES) {
+        stride = sparse ? 0 : paddedStride(col);
+        v = vector<Word>((size_t) row * stride, 0);
+    }
+
+    Row operator [] (uint node1) {
+        if (sparse) return Row(&hash, node1);
+        return Row(&v[(size_t) node1 * stride]);
+    }
+
+    bool get(uint node1, uint node2) const {
+        if (sparse) return hash.contains(EdgeHash::key(node1, node2));
+        return (v[(size_t) node1 * stride + node2 / WORD_BITS] >> (node2 % WORD_BITS)) & 1;
+    }
+
+    uint size() const {
+        return n;
+    }
+
+    bool isSparse() const {
+        return sparse;
+    }
+
+    template <class Archive>
+    void serialize(Archive & archive) {
+        archive(n, cols, stride, sparse, v, hash);
+    }
+
+private:
+    uint n, cols, stride; //stride is in words
+    bool sparse;
+    vector<Word> v;
+    EdgeHash hash;
+
+    static uint paddedStride(uint col) {
+        const uint wordsPerLine = FLAT_MATRIX_CACHE_LINE / sizeof(Word);
+        uint words = (col + WORD_BITS - 1) / WORD_BITS;
+        return ((words + wordsPerLine - 1) / wordsPerLine) * wordsPerLine;
+    }
+};
+
+#endif
@@ -0,0 +1,389 @@
+#include "GraphFileParser.hpp"
+#include <thread>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+MappedTextFile::MappedTextFile(const string& fileName): data(""), size(0) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw runtime_error("File " + fileName + " not found");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw runtime_error("cannot read file " + fileName);
+    }
+    if (st.st_size > 0) {
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw runtime_error("cannot map file " + fileName);
+        }
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        data = (const char*) p;
+        size = st.st_size;
+    }
+    ::close(fd);
+}
+
+MappedTextFile::~MappedTextFile() {
+    if (size > 0) munmap((void*) data, size);
+}
+
+static const uint EMPTY_SLOT = ~0u;
+
+static uint64_t hashName(const char* s, uint len) {
+    //FNV-1a followed by the splitmix64 finalizer, so the low bits used to
+    //pick a slot depend on every character
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (uint i = 0; i < len; i++) {
+        h = (h ^ (unsigned char) s[i]) * 0x100000001b3ULL;
+    }
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+NameInterner::NameInterner(): offsets(1, 0) {}
+
+uint NameInterner::intern(const char* s, uint len) {
+    if (2*(size()+1) > slots.size()) grow();
+    uint64_t h = hashName(s, len);
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask; ; i = (i+1) & mask) {
+        uint id = slots[i];
+        if (id == EMPTY_SLOT) {
+            id = size();
+            slots[i] = id;
+            arena.append(s, len);
+            offsets.push_back(arena.size());
+            hashes.push_back(h);
+            return id;
+        }
+        if (hashes[id] == h and length(id) == len and memcmp(data(id), s, len) == 0) {
+            return id;
+        }
+    }
+}
+
+void NameInterner::grow() {
+    slots.assign(max((size_t) 64, 2*slots.size()), EMPTY_SLOT);
+    size_t mask = slots.size() - 1;
+    for (uint id = 0; id < size(); id++) {
+        size_t i = hashes[id] & mask;
+        while (slots[i] != EMPTY_SLOT) i = (i+1) & mask;
+        slots[i] = id;
+    }
+}
+
+namespace {
+
+typedef pair<const char*, const char*> TextRange;
+
+//below this, splitting a file across threads costs more than it saves
+const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+bool isBlank(char c) {
+    return c == ' ' or c == '\t' or c == '\r' or c == '\v' or c == '\f';
+}
+
+bool isDigit(char c) {
+    return c >= '0' and c <= '9';
+}
+
+//one range per thread, each ending right after a newline (or at the end)
+vector<TextRange> newlineAlignedChunks(const char* begin, const char* end) {
+    size_t bytes = end - begin;
+    size_t count = min((size_t) max(1u, thread::hardware_concurrency()), bytes / MIN_CHUNK_BYTES + 1);
+    vector<TextRange> chunks;
+    const char* start = begin;
+    for (size_t i = 1; i <= count and start < end; i++) {
+        const char* stop = (i == count) ? end : begin + bytes * i / count;
+        if (stop <= start) continue;
+        if (stop < end) {
+            const char* newline = (const char*) memchr(stop-1, '\n', end-(stop-1));
+            stop = newline ? newline+1 : end;
+        }
+        chunks.push_back(TextRange(start, stop));
+        start = stop;
+    }
+    return chunks;
+}
+
+//runs f(0), ..., f(count-1) on their own threads and rethrows the first
+//exception (in chunk order) once all of them are done
+template <typename F>
+void forEachChunk(uint count, F f) {
+    vector<exception_ptr> errors(count);
+    vector<thread> threads;
+    for (uint i = 1; i < count; i++) {
+        threads.push_back(thread([&f, &errors, i]() {
+            try { f(i); } catch (...) { errors[i] = current_exception(); }
+        }));
+    }
+    if (count > 0) {
+        try { f(0); } catch (...) { errors[0] = current_exception(); }
+    }
+    for (auto& t : threads) t.join();
+    for (auto& e : errors) {
+        if (e) rethrow_exception(e);
+    }
+}
+
+//sets [lineBegin, lineEnd) to the next line (without its newline) and
+//advances p past it; false at the end of the text
+bool nextLine(const char*& p, const char* end, const char*& lineBegin, const char*& lineEnd) {
+    if (p >= end) return false;
+    const char* newline = (const char*) memchr(p, '\n', end-p);
+    lineBegin = p;
+    lineEnd = newline ? newline : end;
+    p = newline ? newline+1 : end;
+    return true;
+}
+
+//sets [token, p) to the next blank-separated token of [p, end); false if there is none
+bool nextToken(const char*& p, const char* end, const char*& token) {
+    while (p < end and isBlank(*p)) p++;
+    token = p;
+    while (p < end and not isBlank(*p)) p++;
+    return p > token;
+}
+
+bool parseUint(const char* begin, const char* end, uint& value) {
+    if (begin == end or end - begin > 10) return false;
+    uint64_t v = 0;
+    for (const char* p = begin; p < end; p++) {
+        if (not isDigit(*p)) return false;
+        v = 10*v + (*p - '0');
+    }
+    if (v > EMPTY_SLOT) return false;
+    value = v;
+    return true;
+}
+
+bool parsePositiveInt(const char* begin, const char* end, uint& value) {
+    const char* token;
+    return nextToken(begin, end, token) and parseUint(token, begin, value) and value > 0;
+}
+
+struct EdgeListChunk {
+    NameInterner names;
+    vector<unsigned char> firstColumn;
+    ParsedEdges edges;
+};
+
+void parseEdgeListChunk(TextRange range, bool withValues, const string& fileName, EdgeListChunk& chunk) {
+    const char* p = range.first;
+    const char *lineBegin, *lineEnd;
+    while (nextLine(p, range.second, lineBegin, lineEnd)) {
+        const char* token[3];
+        const char* tokenEnd[3];
+        uint count = 0;
+        const char* q = lineBegin;
+        const char* t;
+        while (nextToken(q, lineEnd, t)) {
+            if (count == 3) {
+                count++;
+                break;
+            }
+            token[count] = t;
+            tokenEnd[count] = q;
+            count++;
+        }
+        if (count < 2 or count > (withValues ? 3u : 2u)) {
+            throw runtime_error("File not in edge-list format: " + fileName);
+        }
+        for (uint k = 0; k < 2; k++) {
+            uint before = chunk.names.size();
+            uint id = chunk.names.intern(token[k], tokenEnd[k] - token[k]);
+            if (id == before) chunk.firstColumn.push_back(k);
+            chunk.edges.endpoints.push_back(id);
+        }
+        if (withValues) {
+            uint value = 1;
+            if (count == 3 and not parseUint(token[2], tokenEnd[2], value)) {
+                throw runtime_error("File not in edge-list format: " + fileName);
+            }
+            chunk.edges.values.push_back(value);
+        }
+    }
+}
+
+struct GwEdgeChunk {
+    ParsedEdges edges;
+    bool failed = false;
+    string failedLine; //first line of the chunk that is not an edge
+};
+
+//an edge line is "node1 node2 0 |{}|" with 1-based node numbers; with
+//values, the number right after the third non-blank character is read
+bool parseGwEdge(const char* p, const char* end, uint numNodes, bool withValues,
+        uint& node1, uint& node2, uint& value) {
+    const char* t;
+    if (not (nextToken(p, end, t) and parseUint(t, p, node1) and nextToken(p, end, t) and parseUint(t, p, node2))) {
+        return false;
+    }
+    if (node1 == 0 or node2 == 0 or node1 > numNodes or node2 > numNodes) {
+        return false;
+    }
+    value = 1;
+    if (withValues) {
+        for (uint k = 0; k < 3; k++) {
+            while (p < end and isBlank(*p)) p++;
+            if (p == end) return false;
+            p++;
+        }
+        while (p < end and isBlank(*p)) p++;
+        if (p < end and isDigit(*p)) {
+            value = 0;
+            for (; p < end and isDigit(*p); p++) value = 10*value + (*p - '0');
+        }
+    }
+    return true;
+}
+
+void parseGwEdgeChunk(TextRange range, uint numNodes, bool withValues, GwEdgeChunk& chunk) {
+    const char* p = range.first;
+    const char *lineBegin, *lineEnd;
+    uint node1, node2, value;
+    while (nextLine(p, range.second, lineBegin, lineEnd)) {
+        if (not parseGwEdge(lineBegin, lineEnd, numNodes, withValues, node1, node2, value)) {
+            chunk.failed = true;
+            chunk.failedLine = string(lineBegin, lineEnd);
+            return;
+        }
+        chunk.edges.endpoints.push_back(node1-1);
+        chunk.edges.endpoints.push_back(node2-1);
+        if (withValues) chunk.edges.values.push_back(value);
+    }
+}
+
+} //namespace
+
+void parseEdgeListFile(const string& fileName, bool withValues, ParsedEdges& edges,
+        NameInterner& nodeNames, vector<unsigned char>& firstColumn) {
+    MappedTextFile file(fileName);
+    vector<TextRange> ranges = newlineAlignedChunks(file.begin(), file.end());
+    uint numChunks = ranges.size();
+    vector<EdgeListChunk> chunks(numChunks);
+    forEachChunk(numChunks, [&](uint c) {
+        parseEdgeListChunk(ranges[c], withValues, fileName, chunks[c]);
+    });
+
+    if (numChunks == 1) {
+        nodeNames = move(chunks[0].names);
+        firstColumn = move(chunks[0].firstColumn);
+        edges = move(chunks[0].edges);
+        return;
+    }
+
+    //numbering the new names of each chunk in chunk order gives the same
+    //order of first appearance as a sequential parse
+    nodeNames = NameInterner();
+    firstColumn.clear();
+    vector<vector<uint> > toGlobal(numChunks);
+    vector<size_t> firstEdge(numChunks+1, 0);
+    for (uint c = 0; c < numChunks; c++) {
+        const NameInterner& local = chunks[c].names;
+        toGlobal[c].resize(local.size());
+        for (uint i = 0; i < local.size(); i++) {
+            uint before = nodeNames.size();
+            toGlobal[c][i] = nodeNames.intern(local.data(i), local.length(i));
+            if (toGlobal[c][i] == before) firstColumn.push_back(chunks[c].firstColumn[i]);
+        }
+        chunks[c].names = NameInterner();
+        firstEdge[c+1] = firstEdge[c] + chunks[c].edges.endpoints.size()/2;
+    }
+    edges.endpoints.resize(2*firstEdge[numChunks]);
+    edges.values.resize(withValues ? firstEdge[numChunks] : 0);
+    forEachChunk(numChunks, [&](uint c) {
+        ParsedEdges& local = chunks[c].edges;
+        for (size_t i = 0; i < local.endpoints.size(); i++) {
+            edges.endpoints[2*firstEdge[c] + i] = toGlobal[c][local.endpoints[i]];
+        }
+        copy(local.values.begin(), local.values.end(), edges.values.begin() + firstEdge[c]);
+        local = ParsedEdges();
+    });
+}
+
+uint parseGwFile(const string& fileName, bool withValues, ParsedEdges& edges) {
+    MappedTextFile file(fileName);
+    const char* p = file.begin();
+    const char* end = file.end();
+    const char *lineBegin = p, *lineEnd = p;
+
+    //ignore header; the node count follows a "-2" line
+    for (uint i = 0; i < 4; i++) {
+        if (not nextLine(p, end, lineBegin, lineEnd)) break;
+    }
+    const char* token;
+    const char* q = lineBegin;
+    if (nextToken(q, lineEnd, token) and string(token, q) == "-2") {
+        nextLine(p, end, lineBegin, lineEnd);
+    }
+    uint numNodes;
+    if (not parsePositiveInt(lineBegin, lineEnd, numNodes)) {
+        throw runtime_error("Failed to read node number: " + string(lineBegin, lineEnd));
+    }
+    //check (and ditch) nodes
+    for (uint i = 0; i < numNodes; i++) {
+        bool hasLine = nextLine(p, end, lineBegin, lineEnd);
+        q = lineBegin;
+        if (not hasLine or not nextToken(q, lineEnd, token)) {
+            throw runtime_error("Failed to read node " + to_string(i) + " of " + to_string(numNodes) +
+                ": " + (hasLine ? string(lineBegin, lineEnd) : string()));
+        }
+    }
+    uint numEdges;
+    bool hasLine = nextLine(p, end, lineBegin, lineEnd);
+    q = lineBegin;
+    if (not hasLine or not nextToken(q, lineEnd, token) or not parseUint(token, q, numEdges)) {
+        throw runtime_error("Failed to read edge number: " + (hasLine ? string(lineBegin, lineEnd) : string()));
+    }
+
+    vector<TextRange> ranges = newlineAlignedChunks(p, end);
+    uint numChunks = ranges.size();
+    vector<GwEdgeChunk> chunks(numChunks);
+    forEachChunk(numChunks, [&](uint c) {
+        parseGwEdgeChunk(ranges[c], numNodes, withValues, chunks[c]);
+    });
+
+    //only the first numEdges lines are edges; anything after them is ignored
+    edges.endpoints.clear();
+    edges.endpoints.reserve(2*(size_t) numEdges);
+    edges.values.clear();
+    if (withValues) edges.values.reserve(numEdges);
+    for (uint c = 0; c < numChunks and edges.endpoints.size() < 2*(size_t) numEdges; c++) {
+        const ParsedEdges& local = chunks[c].edges;
+        size_t take = min(local.endpoints.size()/2, numEdges - edges.endpoints.size()/2);
+        edges.endpoints.insert(edges.endpoints.end(), local.endpoints.begin(), local.endpoints.begin() + 2*take);
+        if (withValues) edges.values.insert(edges.values.end(), local.values.begin(), local.values.begin() + take);
+        if (chunks[c].failed and edges.endpoints.size() < 2*(size_t) numEdges) {
+            throw runtime_error("Failed to read edge: " + chunks[c].failedLine);
+        }
+    }
+    if (edges.endpoints.size() < 2*(size_t) numEdges) {
+        throw runtime_error("Failed to read edge: ");
+    }
+    return numNodes;
+}
+
+void buildCsr(uint numNodes, const vector<uint>& endpoints, vector<uint64_t>& offsets, vector<uint>& neighbors) {
+    offsets.assign(numNodes+1, 0);
+    for (uint node : endpoints) offsets[node+1]++;
+    for (uint i = 0; i < numNodes; i++) offsets[i+1] += offsets[i];
+    neighbors.resize(endpoints.size());
+    vector<uint64_t> next(offsets.begin(), offsets.end()-1);
+    for (size_t i = 0; i < endpoints.size(); i += 2) {
+        neighbors[next[endpoints[i]]++] = endpoints[i+1];
+        neighbors[next[endpoints[i+1]]++] = endpoints[i];
+    }
+}
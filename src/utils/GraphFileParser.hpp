@@ -0,0 +1,76 @@
+#ifndef GRAPHFILEPARSER_HPP
+#define GRAPHFILEPARSER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sys/types.h>
+
+using namespace std;
+
+/*
+Parsers for the network files read by Graph (.gw and edge lists). The file is
+memory-mapped, cut into newline-aligned chunks and each chunk is tokenized by
+its own thread with plain pointer scans instead of getline and istringstream.
+The result is a flat array of edge endpoints that the caller turns into its
+own structures (see buildCsr for the adjacency lists).
+*/
+
+//read-only mapping of a whole file
+class MappedTextFile {
+public:
+    MappedTextFile(const string& fileName);
+    ~MappedTextFile();
+    MappedTextFile(const MappedTextFile&) = delete;
+    MappedTextFile& operator = (const MappedTextFile&) = delete;
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + size; }
+
+private:
+    const char* data;
+    size_t size;
+};
+
+//node names stored back to back in one character arena, numbered in order of
+//first insertion, with an open addressing table of indices for lookups
+class NameInterner {
+public:
+    NameInterner();
+    //index of the name, adding it if it is new
+    uint intern(const char* s, uint length);
+    uint size() const { return offsets.size() - 1; }
+    string name(uint i) const { return string(arena, offsets[i], offsets[i+1] - offsets[i]); }
+    const char* data(uint i) const { return arena.data() + offsets[i]; }
+    uint length(uint i) const { return offsets[i+1] - offsets[i]; }
+
+private:
+    string arena;
+    vector<uint64_t> offsets; //name i is arena[offsets[i], offsets[i+1])
+    vector<uint64_t> hashes;  //hash of name i, to skip most string compares
+    vector<uint> slots;       //name indices, size is a power of 2, at most half full
+    void grow();
+};
+
+struct ParsedEdges {
+    vector<uint> endpoints; //2i and 2i+1 are the end nodes of the i-th edge
+    vector<uint> values;    //value of the i-th edge, only filled if requested
+};
+
+//edge list: one "name1 name2" line per edge, or "name1 name2 value" if
+//withValues (the value defaults to 1). Nodes are numbered in order of first
+//appearance; firstColumn[i] tells if node i first appeared as a name1 (0) or
+//as a name2 (1). Throws if a line has the wrong number of fields.
+void parseEdgeListFile(const string& fileName, bool withValues, ParsedEdges& edges,
+    NameInterner& nodeNames, vector<unsigned char>& firstColumn);
+
+//LEDA .gw file; returns the number of nodes. Node names are checked but not
+//stored. With withValues, the value after the "0 |{" of each edge is read
+//(defaulting to 1), as MULTI_PAIRWISE expects.
+uint parseGwFile(const string& fileName, bool withValues, ParsedEdges& edges);
+
+//compressed sparse row adjacency: the neighbors of node u are
+//neighbors[offsets[u], offsets[u+1]), in the order the edges were given
+void buildCsr(uint numNodes, const vector<uint>& endpoints, vector<uint64_t>& offsets, vector<uint>& neighbors);
+
+#endif
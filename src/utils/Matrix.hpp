@@ -3,6 +3,7 @@
 
 #include "utils.hpp"
 #include "SparseMatrix.hpp"
+#include "FlatMatrix.hpp"
 #include <vector>
 
 using namespace std;
@@ -13,12 +14,20 @@ using namespace std;
     #define MATRIX_UNIT bool
 #endif
     
+// Backend selection: SPARSE uses hash maps per row (for huge, very sparse networks),
+// NESTED_MATRIX keeps the old vector<vector<T> > layout, and the default is the
+// flat, cache line padded FlatMatrix (bit-packed when T is bool, and switching by
+// itself to an edge hash when the network is too large for a dense bit matrix).
 #ifdef SPARSE
-    #define INNER_CONTAINER unordered_map<uint, T> 
+    #define INNER_CONTAINER unordered_map<uint, T> &
     #define MATRIX_DATA_STRUCTURE SparseMatrix<T>
-#else
-    #define INNER_CONTAINER vector<T> 
+#elif defined(NESTED_MATRIX)
+    #define INNER_CONTAINER vector<T> &
     #define MATRIX_DATA_STRUCTURE vector<vector<T> >
+#else
+    #define FLAT_MATRIX
+    #define INNER_CONTAINER typename FlatMatrix<T>::Row
+    #define MATRIX_DATA_STRUCTURE FlatMatrix<T>
 #endif
 
 template <typename T>
@@ -30,7 +39,7 @@ public:
     Matrix(uint row, uint col);
 
     Matrix & operator = (const Matrix & matrix);
-    INNER_CONTAINER & operator [] (uint node1);
+    INNER_CONTAINER operator [] (uint node1);
 
     const T get(uint node1, uint node2) const;
     uint size() const;
@@ -46,7 +55,7 @@ private:
 
 
 template <typename T>
-inline INNER_CONTAINER & Matrix<T>::operator [] (uint node1) {
+inline INNER_CONTAINER Matrix<T>::operator [] (uint node1) {
     return data[node1];
 }
 
@@ -54,6 +63,8 @@ template <typename T>
 Matrix<T>::Matrix(uint row, uint col) {
 #ifdef SPARSE
     data = MATRIX_DATA_STRUCTURE(row);
+#elif defined(FLAT_MATRIX)
+    data = MATRIX_DATA_STRUCTURE(row, col);
 #else
     data = MATRIX_DATA_STRUCTURE(row, 
            vector<T>(col, T()));
@@ -62,7 +73,7 @@ Matrix<T>::Matrix(uint row, uint col) {
 
 template <typename T>
 inline const T Matrix<T>::get(uint node1, uint node2) const {
-#ifdef SPARSE
+#if defined(SPARSE) || defined(FLAT_MATRIX)
     return data.get(node1, node2);
 #else
     return data[node1][node2];
@@ -82,6 +93,8 @@ template <typename T>
 Matrix<T>::Matrix(uint numberOfNodes) {
 #ifdef SPARSE
     data = MATRIX_DATA_STRUCTURE(numberOfNodes);
+#elif defined(FLAT_MATRIX)
+    data = MATRIX_DATA_STRUCTURE(numberOfNodes, numberOfNodes);
 #else
     data = MATRIX_DATA_STRUCTURE(numberOfNodes, 
            vector<T>(numberOfNodes, T()));
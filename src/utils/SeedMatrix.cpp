@@ -1,10 +1,9 @@
 #include "SeedMatrix.hpp"
 
 SeedMatrix::SeedMatrix(MeasureCombination * MC, double delta, bool isMaxHeap, std::unordered_set<uint> & lex, std::unordered_set<uint> & rex) :
-  delta(delta), isMaxHeap(isMaxHeap),
+  sims(MC->getAggregatedLocalSims()), delta(delta), isMaxHeap(isMaxHeap),
   left_exclude(lex), right_exclude(rex)
 {
-  sims = MC->getAggregatedLocalSims();
   init_ptr = 0;
   init_column_vector();
   
@@ -125,7 +124,7 @@ uint SeedMatrix::bin_search(vector<node_t> & vec, float val, uint i, uint j){
 
 vector<node_t> * SeedMatrix::create_node(uint node_num){
   std::cout << "create node " << node_num << std::endl;
-  vector<float> & sim_row = sims[node_num];
+  SimMatrix::ConstRow sim_row = sims[node_num];
   std::cout << "row size" << sim_row.size() << std::endl;
   vector<node_t> * out = new vector<node_t>();
   out->reserve(sim_row.size());
@@ -0,0 +1,244 @@
+#ifndef SIMMATRIX_HPP
+#define SIMMATRIX_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <sys/types.h>
+
+using namespace std;
+
+/*
+Node similarity matrix of two networks (n1 rows, n2 columns) as computed by
+the local measures. All the entries are in a single 64-byte aligned block,
+row-major, with every row padded to a whole number of cache lines so that each
+row starts on a cache line. A matrix owns its block and can be moved but not
+copied: it is built once by its measure (or by MeasureCombination) and every
+other user keeps a reference to it.
+
+sims[i][j] and sims[i].size() read as they did with vector<vector<float> >;
+writing goes through sims.writableRow(i)[j].
+
+A matrix can also hold 16 or 8-bit fixed point entries: value = offset + q*step,
+where offset and step are chosen per matrix from the range of its values. That
+takes a half or a quarter of the memory and is off by at most step/2 per entry.
+Quantized matrices are read-only: operator [] and get() read any matrix, and
+writableRow throws for them.
+*/
+
+#define SIM_MATRIX_ALIGNMENT 64
+
+class SimMatrix {
+public:
+    class Row {
+    public:
+        Row(float* p, uint n): p(p), n(n) {}
+        float& operator [] (uint j) const { return p[j]; }
+        uint size() const { return n; }
+    private:
+        float* p;
+        uint n;
+    };
+
+    class ConstRow {
+    public:
+        ConstRow(const SimMatrix* m, const char* p): m(m), p(p) {}
+        float operator [] (uint j) const { return m->decode(p, j); }
+        uint size() const { return m->n2; }
+    private:
+        const SimMatrix* m;
+        const char* p;
+    };
+
+    SimMatrix(): n1(0), n2(0), stride(0), bits(32), offset(0), step(0), data(nullptr) {}
+
+    SimMatrix(uint rows, uint cols, float value = 0): SimMatrix() {
+        allocate(rows, cols, 32);
+        float* p = (float*) data;
+        size_t count = (size_t) n1 * stride;
+        if (value == 0) {
+            memset(data, 0, count * sizeof(float));
+        } else {
+            for (size_t k = 0; k < count; k++) p[k] = value;
+        }
+    }
+
+    //entries of bits (32, 16 or 8) bits covering the range [lo, hi], all set
+    //to lo; the rows are then filled with setRow
+    SimMatrix(uint rows, uint cols, uint bits, float lo, float hi): SimMatrix() {
+        if (bits != 32 and bits != 16 and bits != 8) {
+            throw runtime_error("similarity matrices have 32, 16 or 8 bits per entry, not " + to_string(bits));
+        }
+        allocate(rows, cols, bits);
+        memset(data, 0, (size_t) n1 * stride * (bits / 8));
+        if (bits < 32) {
+            offset = lo;
+            step = hi > lo ? (hi - lo) / levels() : 0;
+        }
+    }
+
+    ~SimMatrix() {
+        free(data);
+    }
+
+    SimMatrix(SimMatrix&& other) noexcept {
+        steal(other);
+    }
+
+    SimMatrix& operator = (SimMatrix&& other) noexcept {
+        if (this != &other) {
+            free(data);
+            steal(other);
+        }
+        return *this;
+    }
+
+    SimMatrix(const SimMatrix&) = delete;
+    SimMatrix& operator = (const SimMatrix&) = delete;
+
+    ConstRow operator [] (uint i) const {
+        return ConstRow(this, data + (size_t) i * stride * (bits / 8));
+    }
+
+    //row i for writing, only for 32-bit matrices
+    Row writableRow(uint i) {
+        if (bits != 32) {
+            throw runtime_error("a quantized similarity matrix cannot be written to");
+        }
+        return Row((float*) data + (size_t) i * stride, n2);
+    }
+
+    float get(uint i, uint j) const {
+        return decode(data + (size_t) i * stride * (bits / 8), j);
+    }
+
+    //quantizes values[0..n2) into row i
+    void setRow(uint i, const float* values) {
+        char* p = data + (size_t) i * stride * (bits / 8);
+        if (bits == 32) {
+            memcpy(p, values, n2 * sizeof(float));
+        } else if (bits == 16) {
+            for (uint j = 0; j < n2; j++) ((uint16_t*) p)[j] = encode(values[j]);
+        } else {
+            for (uint j = 0; j < n2; j++) ((uint8_t*) p)[j] = encode(values[j]);
+        }
+    }
+
+    //converts a float matrix to bits per entry in place
+    void quantize(uint bits) {
+        if (bits == this->bits) return;
+        if (this->bits != 32) {
+            throw runtime_error("a similarity matrix can only be quantized once");
+        }
+        float lo, hi;
+        valueRange(lo, hi);
+        SimMatrix q(n1, n2, bits, lo, hi);
+        for (uint i = 0; i < n1; i++) {
+            q.setRow(i, (float*) data + (size_t) i * stride);
+        }
+        *this = move(q);
+    }
+
+    //smallest and largest value (0 and 0 for an empty matrix)
+    void valueRange(float& lo, float& hi) const {
+        if (empty()) {
+            lo = hi = 0;
+        } else if (bits < 32) {
+            lo = offset;
+            hi = offset + step * levels();
+        } else {
+            lo = hi = get(0, 0);
+            for (uint i = 0; i < n1; i++) {
+                const float* row = (const float*) data + (size_t) i * stride;
+                for (uint j = 0; j < n2; j++) {
+                    lo = min(lo, row[j]);
+                    hi = max(hi, row[j]);
+                }
+            }
+        }
+    }
+
+    //number of rows, like the size() of the nested vector this replaces
+    uint size() const { return n1; }
+    uint numRows() const { return n1; }
+    uint numCols() const { return n2; }
+    bool empty() const { return n1 == 0 or n2 == 0; }
+    uint bitsPerEntry() const { return bits; }
+    bool isQuantized() const { return bits < 32; }
+    //distance between consecutive representable values, 0 if not quantized
+    float quantizationStep() const { return step; }
+    //bytes of the block, padding included
+    size_t allocatedBytes() const { return (size_t) n1 * stride * (bits / 8); }
+
+    //raw n1 x n2 floats, one row after the other and without the padding,
+    //the layout writeMatrixToBinaryFile used for the nested vectors
+    void writeToBinaryFile(const string& fileName) const {
+        ofstream fout(fileName.c_str(), ios::out | ios::binary);
+        vector<float> row(n2);
+        for (uint i = 0; i < n1; i++) {
+            for (uint j = 0; j < n2; j++) row[j] = get(i, j);
+            fout.write((const char*) row.data(), n2 * sizeof(float));
+        }
+        fout.close();
+    }
+
+    //the matrix must already have the dimensions of the file and 32 bits
+    void readFromBinaryFile(const string& fileName) {
+        ifstream fin(fileName.c_str(), ios::in | ios::binary);
+        for (uint i = 0; i < n1; i++) {
+            if (not fin.read((char*) &writableRow(i)[0], n2 * sizeof(float))) {
+                throw runtime_error("truncated similarity matrix file " + fileName);
+            }
+        }
+    }
+
+private:
+    uint n1, n2, stride; //stride in entries
+    uint bits;
+    float offset, step;
+    char* data;
+
+    uint levels() const {
+        return (1u << bits) - 1;
+    }
+
+    float decode(const char* row, uint j) const {
+        if (bits == 32) return ((const float*) row)[j];
+        if (bits == 16) return offset + step * ((const uint16_t*) row)[j];
+        return offset + step * ((const uint8_t*) row)[j];
+    }
+
+    uint encode(float value) const {
+        if (step == 0) return 0;
+        float q = roundf((value - offset) / step);
+        return q <= 0 ? 0 : (q >= levels() ? levels() : (uint) q);
+    }
+
+    void allocate(uint rows, uint cols, uint bits) {
+        this->bits = bits;
+        n1 = rows;
+        n2 = cols;
+        const uint perLine = SIM_MATRIX_ALIGNMENT / (bits / 8);
+        stride = ((cols + perLine - 1) / perLine) * perLine;
+        size_t bytes = (size_t) n1 * stride * (bits / 8);
+        if (bytes > 0 and posix_memalign((void**) &data, SIM_MATRIX_ALIGNMENT, bytes) != 0) {
+            throw bad_alloc();
+        }
+    }
+
+    void steal(SimMatrix& other) {
+        n1 = other.n1; n2 = other.n2; stride = other.stride;
+        bits = other.bits; offset = other.offset; step = other.step;
+        data = other.data;
+        other.n1 = other.n2 = other.stride = 0;
+        other.data = nullptr;
+    }
+};
+
+#endif
@@ -0,0 +1,196 @@
+#include "SimMatrixFile.hpp"
+#include "FlatBinary.hpp"
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+
+using namespace std;
+
+static const char SIM_FILE_MAGIC[8] = {'S','A','N','A','S','I','M','F'};
+static const uint32_t SIM_FILE_VERSION = 1;
+
+void SimMatrixFile::write(const SimMatrix& sim, const string& fileName, int format,
+        const vector<string>& names1, const vector<string>& names2, uint topK) {
+    switch (format) {
+    case INDICES:
+    case NAMES:
+    case MATRIX:
+        writeText(sim, fileName, format, names1, names2, topK);
+        break;
+    case BINARY:
+        writeBinary(sim, fileName, topK);
+        break;
+    default:
+        throw runtime_error("unknown similarity file format " + to_string(format));
+    }
+}
+
+vector<uint> SimMatrixFile::topColumns(const SimMatrix& sim, uint i, uint topK) {
+    uint n2 = sim.numCols();
+    topK = min(topK, n2);
+    vector<float> row(n2);
+    for (uint j = 0; j < n2; j++) row[j] = sim.get(i, j);
+    vector<uint> cols(n2);
+    iota(cols.begin(), cols.end(), 0);
+    partial_sort(cols.begin(), cols.begin() + topK, cols.end(), [&row](uint a, uint b) {
+        return row[a] > row[b] or (row[a] == row[b] and a < b);
+    });
+    cols.resize(topK);
+    return cols;
+}
+
+//rows [iBegin, iEnd) in format, appended to buf
+static void formatRows(const SimMatrix& sim, uint iBegin, uint iEnd, int format,
+        const vector<string>& names1, const vector<string>& names2, uint topK, string& buf) {
+    char num[64];
+    uint n2 = sim.numCols();
+    vector<uint> cols;
+    if (topK == 0) {
+        cols.resize(n2);
+        iota(cols.begin(), cols.end(), 0);
+    }
+    for (uint i = iBegin; i < iEnd; i++) {
+        if (topK > 0) cols = SimMatrixFile::topColumns(sim, i, topK);
+        for (uint j : cols) {
+            //%g is what operator << prints for floats
+            if (format == SimMatrixFile::INDICES) {
+                snprintf(num, sizeof(num), "%u %u %g\n", i, j, sim.get(i, j));
+                buf += num;
+            } else if (format == SimMatrixFile::NAMES) {
+                snprintf(num, sizeof(num), " %g\n", sim.get(i, j));
+                buf += names1[i];
+                buf += ' ';
+                buf += names2[j];
+                buf += num;
+            } else {
+                snprintf(num, sizeof(num), j+1 < n2 ? "%g " : "%g\n", sim.get(i, j));
+                buf += num;
+            }
+        }
+    }
+}
+
+void SimMatrixFile::writeText(const SimMatrix& sim, const string& fileName, int format,
+        const vector<string>& names1, const vector<string>& names2, uint topK) {
+    if (format == MATRIX and topK > 0) {
+        throw runtime_error("similarity format 2 has every entry, it cannot be written with a top k");
+    }
+    if (format == NAMES and (names1.size() != sim.numRows() or names2.size() != sim.numCols())) {
+        throw runtime_error("similarity format 1 needs the names of all the nodes");
+    }
+    ofstream fout(fileName.c_str(), ios::out | ios::binary);
+    if (not fout.is_open()) {
+        throw runtime_error("cannot write similarity file " + fileName);
+    }
+    const uint ROW_BLOCK = 16;
+    uint n1 = sim.numRows();
+    uint numThreads = max(1u, thread::hardware_concurrency());
+    vector<string> buffers(numThreads);
+    for (uint batch = 0; batch < n1; batch += numThreads * ROW_BLOCK) {
+        auto worker = [&](uint t) {
+            buffers[t].clear();
+            uint iBegin = min(n1, batch + t * ROW_BLOCK);
+            uint iEnd = min(n1, iBegin + ROW_BLOCK);
+            formatRows(sim, iBegin, iEnd, format, names1, names2, topK, buffers[t]);
+        };
+        vector<thread> threads;
+        for (uint t = 1; t < numThreads; t++) {
+            threads.push_back(thread(worker, t));
+        }
+        worker(0);
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (const string& buf : buffers) {
+            fout.write(buf.data(), buf.size());
+        }
+    }
+    if (not fout) {
+        throw runtime_error("error writing similarity file " + fileName);
+    }
+}
+
+void SimMatrixFile::writeBinary(const SimMatrix& sim, const string& fileName, uint topK) {
+    uint n1 = sim.numRows();
+    uint n2 = sim.numCols();
+    topK = min(topK, n2);
+    FlatBinaryWriter out(fileName, SIM_FILE_MAGIC, SIM_FILE_VERSION);
+    out.writeScalar(n1);
+    out.writeScalar(n2);
+    out.writeScalar(topK);
+    if (topK == 0) {
+        //a row per section
+        vector<float> row(n2);
+        for (uint i = 0; i < n1; i++) {
+            for (uint j = 0; j < n2; j++) row[j] = sim.get(i, j);
+            out.writeVector(row);
+        }
+    } else {
+        //topK columns and values per row
+        vector<uint> cols((size_t) n1 * topK);
+        vector<float> values((size_t) n1 * topK);
+        atomic<uint> nextRow(0);
+        auto worker = [&]() {
+            for (uint i = nextRow++; i < n1; i = nextRow++) {
+                vector<uint> top = topColumns(sim, i, topK);
+                for (uint k = 0; k < topK; k++) {
+                    cols[(size_t) i * topK + k] = top[k];
+                    values[(size_t) i * topK + k] = sim.get(i, top[k]);
+                }
+            }
+        };
+        uint numThreads = max(1u, thread::hardware_concurrency());
+        vector<thread> threads;
+        for (uint t = 1; t < numThreads; t++) {
+            threads.push_back(thread(worker));
+        }
+        worker();
+        for (auto& t : threads) {
+            t.join();
+        }
+        out.writeVector(cols);
+        out.writeVector(values);
+    }
+    out.close();
+}
+
+void SimMatrixFile::readBinary(const string& fileName, SimMatrix& sims) {
+    FlatBinaryReader in(fileName, SIM_FILE_MAGIC, SIM_FILE_VERSION);
+    uint n1 = in.readScalar<uint>();
+    uint n2 = in.readScalar<uint>();
+    uint topK = in.readScalar<uint>();
+    if (n1 != sims.numRows() or n2 != sims.numCols()) {
+        throw runtime_error("similarity file " + fileName + " is " + to_string(n1) + " x " + to_string(n2) +
+            ", the networks have " + to_string(sims.numRows()) + " and " + to_string(sims.numCols()) + " nodes");
+    }
+    uint64_t count;
+    if (topK == 0) {
+        for (uint i = 0; i < n1; i++) {
+            const float* row = in.readArray<float>(count);
+            if (count != n2) {
+                throw runtime_error("corrupt similarity file " + fileName);
+            }
+            memcpy(&sims.writableRow(i)[0], row, n2 * sizeof(float));
+        }
+    } else {
+        uint64_t valueCount;
+        const uint* cols = in.readArray<uint>(count);
+        const float* values = in.readArray<float>(valueCount);
+        if (count != (uint64_t) n1 * topK or valueCount != count) {
+            throw runtime_error("corrupt similarity file " + fileName);
+        }
+        for (uint i = 0; i < n1; i++) {
+            auto row = sims.writableRow(i);
+            for (uint k = 0; k < topK; k++) {
+                uint j = cols[(size_t) i * topK + k];
+                if (j >= n2) {
+                    throw runtime_error("corrupt similarity file " + fileName);
+                }
+                row[j] = values[(size_t) i * topK + k];
+            }
+        }
+    }
+}
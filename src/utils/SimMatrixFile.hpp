@@ -0,0 +1,45 @@
+#ifndef SIMMATRIXFILE_HPP
+#define SIMMATRIXFILE_HPP
+
+#include <string>
+#include <vector>
+#include "SimMatrix.hpp"
+
+using namespace std;
+
+/*
+Similarity matrix files, as written by "-mode similarity" and read by -esim,
+in the formats of -simFormat:
+0: "i j sim" lines, with the node numbers of the .gw files
+1: "name1 name2 sim" lines
+2: one line of n2 similarities per G1 node
+3: binary (FlatBinary, so it is read by mapping it)
+
+Instead of all n1*n2 entries, formats 0, 1 and 3 can keep only the topK
+largest similarities of each row (ties go to the smaller column), most similar
+first; the entries left out read as 0.
+
+Text is formatted by blocks of rows in parallel and written in order, so the
+files are the same whatever the number of threads.
+*/
+class SimMatrixFile {
+public:
+    enum Format { INDICES = 0, NAMES = 1, MATRIX = 2, BINARY = 3 };
+
+    //names1 and names2 are only used by NAMES; topK = 0 writes every entry
+    static void write(const SimMatrix& sim, const string& fileName, int format,
+        const vector<string>& names1, const vector<string>& names2, uint topK = 0);
+
+    //reads a BINARY file into sims, which must already be n1 x n2 and 32 bits
+    static void readBinary(const string& fileName, SimMatrix& sims);
+
+    //columns of the topK largest entries of row i, most similar first
+    static vector<uint> topColumns(const SimMatrix& sim, uint i, uint topK);
+
+private:
+    static void writeText(const SimMatrix& sim, const string& fileName, int format,
+        const vector<string>& names1, const vector<string>& names2, uint topK);
+    static void writeBinary(const SimMatrix& sim, const string& fileName, uint topK);
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+#include "RandomMoves.hpp"
+#include "../src/Alignment.hpp"
+#include "../src/measures/LargestCommonConnectedSubgraph.hpp"
+
+//size of the largest common connected component of A, from scratch
+static uint largestFromScratch(const Graph& G1, const Graph& G2, const vector<uint>& A) {
+    vector<vector<uint> > components;
+    vector<uint> componentEdges;
+    Alignment(A).commonConnectedComponents(G1, G2, components, componentEdges);
+    uint largest = 0;
+    for (const auto& c : components) largest = max(largest, (uint) c.size());
+    return largest;
+}
+
+//checks every proposed size, and the tracked size after every accepted move,
+//against a recomputation
+static void checkRandomMoves(uint n1, uint m1, uint n2, uint m2, uint seed, uint moves) {
+    mt19937 gen(seed);
+    Graph G1 = randomGraph(n1, m1, gen);
+    Graph G2 = randomGraph(n2, m2, gen);
+    RandomMoves R(n1, n2, gen);
+
+    LargestCommonConnectedSubgraph lccs(&G1, &G2, false);
+    lccs.initIncremental(R.A);
+    ASSERT_EQ(largestFromScratch(G1, G2, R.A), lccs.largestSize());
+
+    for (uint k = 0; k < moves; k++) {
+        const RandomMoves::Move& m = R.propose();
+        uint proposed = m.swap ?
+            lccs.swapOpLargest(R.A, m.source1, m.source2) :
+            lccs.changeOpLargest(R.A, m.source1, m.target);
+        ASSERT_EQ(largestFromScratch(G1, G2, R.B), proposed) << "move " << k;
+        if (R.acceptHalf()) {
+            lccs.commitMove();
+            ASSERT_EQ(largestFromScratch(G1, G2, R.A), lccs.largestSize()) << "move " << k;
+        }
+    }
+}
+
+//identity alignment of G1 into G2, with the extra G2 nodes unassigned
+static vector<uint> identity(uint n) {
+    vector<uint> A(n);
+    for (uint i = 0; i < n; i++) A[i] = i;
+    return A;
+}
+
+TEST(LargestCommonConnectedSubgraph_UT, incrementalSizeMatchesSparseGraphs) {
+    checkRandomMoves(60, 70, 80, 110, 1, 20000);
+}
+
+TEST(LargestCommonConnectedSubgraph_UT, incrementalSizeMatchesDenseGraphs) {
+    checkRandomMoves(50, 300, 60, 450, 2, 20000);
+}
+
+TEST(LargestCommonConnectedSubgraph_UT, incrementalSizeMatchesSameSizeGraphs) {
+    checkRandomMoves(40, 80, 40, 80, 3, 20000);
+}
+
+TEST(LargestCommonConnectedSubgraph_UT, movingAwayHubSplitsComponent) {
+    //the same star in G1 and G2; G2 has one extra, isolated node
+    vector<vector<uint> > star;
+    for (uint i = 1; i < 8; i++) star.push_back({0, i});
+    Graph G1(8, star), G2(9, star);
+    vector<uint> A = identity(8);
+    LargestCommonConnectedSubgraph lccs(&G1, &G2, false);
+    lccs.initIncremental(A);
+    ASSERT_EQ(8u, lccs.largestSize());
+
+    //aligning the hub to the isolated node leaves only singletons
+    EXPECT_EQ(1u, lccs.changeOpLargest(A, 0, 8));
+    lccs.commitMove();
+    A[0] = 8;
+    EXPECT_EQ(1u, lccs.largestSize());
+
+    //and moving it back joins them again
+    EXPECT_EQ(8u, lccs.changeOpLargest(A, 0, 0));
+    lccs.commitMove();
+    A[0] = 0;
+    EXPECT_EQ(8u, lccs.largestSize());
+}
+
+TEST(LargestCommonConnectedSubgraph_UT, swapsInsideOneComponent) {
+    //a 4-clique and a separate edge, in both graphs
+    vector<vector<uint> > edges = {{0,1}, {0,2}, {0,3}, {1,2}, {1,3}, {2,3}, {4,5}};
+    Graph G1(6, edges), G2(6, edges);
+    vector<uint> A = identity(6);
+    LargestCommonConnectedSubgraph lccs(&G1, &G2, false);
+    lccs.initIncremental(A);
+    ASSERT_EQ(4u, lccs.largestSize());
+
+    //the clique is symmetric, so a swap inside it keeps every edge
+    EXPECT_EQ(4u, lccs.swapOpLargest(A, 0, 3));
+    lccs.commitMove();
+    swap(A[0], A[3]);
+    EXPECT_EQ(4u, lccs.largestSize());
+
+    //a swap with the other component takes one node out of the clique
+    EXPECT_EQ(3u, lccs.swapOpLargest(A, 1, 4));
+}
+
+TEST(LargestCommonConnectedSubgraph_UT, swapWithItselfChangesNothing) {
+    mt19937 gen(5);
+    Graph G1 = randomGraph(30, 60, gen);
+    Graph G2 = randomGraph(30, 60, gen);
+    RandomMoves R(30, 30, gen);
+    LargestCommonConnectedSubgraph lccs(&G1, &G2, false);
+    lccs.initIncremental(R.A);
+    uint before = lccs.largestSize();
+    for (uint source = 0; source < 30; source++) {
+        EXPECT_EQ(before, lccs.swapOpLargest(R.A, source, source));
+        lccs.commitMove();
+        EXPECT_EQ(before, lccs.largestSize());
+    }
+}
+
+TEST(LargestCommonConnectedSubgraph_UT, nodeProportionMatchesLargestSize) {
+    mt19937 gen(4);
+    Graph G1 = randomGraph(60, 90, gen);
+    Graph G2 = randomGraph(60, 90, gen);
+    RandomMoves R(60, 60, gen);
+    LargestCommonConnectedSubgraph lccs(&G1, &G2, false);
+    lccs.initIncremental(R.A);
+    EXPECT_DOUBLE_EQ(lccs.largestSize() / 60.0, lccs.nodeProportion(Alignment(R.A)));
+}
@@ -0,0 +1,72 @@
+#ifndef RANDOMMOVES_HPP
+#define RANDOMMOVES_HPP
+
+#include <random>
+#include <algorithm>
+#include <vector>
+#include "../src/Graph.hpp"
+
+//graph with n nodes and m distinct random edges
+inline Graph randomGraph(uint n, uint m, mt19937& gen) {
+    vector<vector<bool> > present(n, vector<bool> (n, false));
+    vector<vector<uint> > edges;
+    uniform_int_distribution<uint> node(0, n-1);
+    while (edges.size() < m) {
+        uint u = node(gen), v = node(gen);
+        if (u == v or present[u][v]) continue;
+        present[u][v] = present[v][u] = true;
+        edges.push_back({u, v});
+    }
+    return Graph(n, edges);
+}
+
+//a random alignment of n1 nodes into n2 and random change and swap moves on
+//it, as SANA proposes them. propose() fills move and B, the alignment after
+//the move; acceptHalf() then makes B the current alignment half of the time.
+//With n1 == n2 there are no unassigned nodes, so every move is a swap.
+//A swap may have source1 == source2
+class RandomMoves {
+public:
+    struct Move {
+        bool swap;
+        uint source1, source2; //source2 only for swaps
+        uint target;           //new image of source1, only for changes
+    };
+
+    vector<uint> A, B;
+    Move move;
+
+    RandomMoves(uint n1, uint n2, mt19937& gen): gen(gen) {
+        vector<uint> perm(n2);
+        for (uint i = 0; i < n2; i++) perm[i] = i;
+        shuffle(perm.begin(), perm.end(), gen);
+        A.assign(perm.begin(), perm.begin() + n1);
+        unassigned.assign(perm.begin() + n1, perm.end());
+    }
+
+    const Move& propose() {
+        move.source1 = gen() % A.size();
+        move.source2 = gen() % A.size();
+        move.swap = unassigned.empty() or gen() % 2;
+        u = move.swap ? 0 : gen() % unassigned.size();
+        move.target = move.swap ? 0 : unassigned[u];
+        B = A;
+        if (move.swap) swap(B[move.source1], B[move.source2]);
+        else B[move.source1] = move.target;
+        return move;
+    }
+
+    bool acceptHalf() {
+        if (gen() % 2 == 0) return false;
+        if (not move.swap) unassigned[u] = A[move.source1];
+        A = B;
+        return true;
+    }
+
+private:
+    mt19937& gen;
+    vector<uint> unassigned;
+    uint u;
+};
+
+#endif
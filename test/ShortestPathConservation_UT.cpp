@@ -0,0 +1,39 @@
+#include "gtest/gtest.h"
+#include "RandomMoves.hpp"
+#include "../src/Alignment.hpp"
+#include "../src/measures/ShortestPathConservation.hpp"
+
+//checks every delta against distanceDifferenceSum recomputed after the move
+static void checkRandomMoves(uint n1, uint m1, uint n2, uint m2, uint seed, uint moves) {
+    mt19937 gen(seed);
+    Graph G1 = randomGraph(n1, m1, gen);
+    Graph G2 = randomGraph(n2, m2, gen);
+    RandomMoves R(n1, n2, gen);
+
+    ShortestPathConservation spc(&G1, &G2);
+    int64_t sum = spc.distanceDifferenceSum(Alignment(R.A));
+
+    for (uint k = 0; k < moves; k++) {
+        const RandomMoves::Move& m = R.propose();
+        if (m.swap and m.source1 == m.source2) continue;
+        int64_t delta = m.swap ?
+            spc.swapOpDelta(R.A, m.source1, m.source2, R.A[m.source1], R.A[m.source2]) :
+            spc.changeOpDelta(R.A, m.source1, R.A[m.source1], m.target);
+        int64_t newSum = spc.distanceDifferenceSum(Alignment(R.B));
+        ASSERT_EQ(newSum - sum, delta) << "move " << k;
+        if (R.acceptHalf()) sum = newSum;
+    }
+}
+
+TEST(ShortestPathConservation_UT, deltasMatchConnectedGraphs) {
+    checkRandomMoves(50, 150, 70, 250, 1, 3000);
+}
+
+TEST(ShortestPathConservation_UT, deltasMatchDisconnectedGraphs) {
+    //sparse enough to have unreachable pairs, which cost maxDist
+    checkRandomMoves(60, 40, 80, 60, 2, 3000);
+}
+
+TEST(ShortestPathConservation_UT, deltasMatchSameSizeGraphs) {
+    checkRandomMoves(40, 60, 40, 60, 3, 3000);
+}
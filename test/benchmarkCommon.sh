@@ -0,0 +1,36 @@
+#!/bin/bash
+
+# Shared by the test/*Benchmark.sh scripts, which source it. Each of them
+# compares SANA builds on one step and is run from the repository root as
+#   test/<name>Benchmark.sh [sana binary...]
+# e.g. test/tcBenchmark.sh ./sana ../sana-old/sana
+# With no arguments only ./sana is measured.
+
+binaries="$@"
+if [[ -z $binaries ]]
+then
+    binaries="./sana"
+fi
+first=`echo $binaries | cut -d ' ' -f 1`
+
+declare -a pairs=(
+  "yeast human"
+  "RNorvegicus HSapiens"
+)
+
+# a fixed temperature schedule, so that the runs do not spend their time
+# searching for one
+fixedSchedule="-tinitial 0.0005 -tdecay 5 -t 0.1"
+
+# iterationRate sana args...: the iterations per second of the run
+iterationRate() {
+    "$@" 2>&1 | grep -a "iterations per second" | tail -1 | sed -e 's/SANA does \([0-9.]*\) iterations.*/\1/'
+}
+
+# printedTime marker sana args...: the time printed on the first line of the
+# run that contains marker, as "marker (time)" or "marker time"
+printedTime() {
+    local marker=$1
+    shift
+    "$@" 2>&1 | grep -a -m 1 "$marker" | sed -e 's/.*(\(.*\))$/\1/' -e "s/.*$marker *//"
+}
@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# Compares how long SANA builds take to evaluate the global measures of an
+# alignment, which is what MeasureCombination::eval does for the report and
+# every time trackProgress checks the incremental score. Only the "printing
+# scores done" time of the report is kept. The alignment of each pair is made
+# once, by the first binary.
+# Usage: see test/benchmarkCommon.sh
+
+. `dirname $0`/benchmarkCommon.sh
+
+measures="-ec 0.2 -s3 0.2 -ics 0.2 -sec 0.2 -tc 0.2"
+dir=`mktemp -d`
+
+echo "Running SANA evaluation benchmark"
+
+for pair in "${pairs[@]}"; do
+    set -- $pair
+    $first -g1 $1 -g2 $2 -ec 1 -t 0.01 -o $dir/start > /dev/null 2>&1
+    for sana in $binaries; do
+        time=`printedTime "printing scores done" $sana -g1 $1 -g2 $2 $measures -eval $dir/start.align -o $dir/eval`
+        echo "$1-$2 $sana: $time"
+    done
+done
+
+rm -rf $dir
@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# Compares how long SANA builds take to load a large synthetic network, both
+# as an edge list and as a .gw file. Only the "Graph loading completed" time
+# is reported; each run is stopped as soon as it is printed.
+# Usage: see test/benchmarkCommon.sh
+# The network size can be changed with NODES and EDGES (EDGES < NODES*NODES/2).
+
+. `dirname $0`/benchmarkCommon.sh
+
+nodes=${NODES:-200000}
+edges=${EDGES:-2000000}
+dir=`mktemp -d`
+
+echo "Generating a network with $nodes nodes and $edges edges"
+# edge i joins node a = i%nodes to a+k, k = 1+i/nodes, so there are no duplicates
+awk -v n=$nodes -v m=$edges 'BEGIN {
+    for (i = 0; i < m; i++) {
+        a = i % n; b = (a + 1 + int(i / n)) % n
+        print "node" a " node" b
+    }
+}' > $dir/big.el
+awk -v n=$nodes -v m=$edges 'BEGIN {
+    print "LEDA.GRAPH"; print "string"; print "short"; print "-2"; print n
+    for (i = 0; i < n; i++) print "|{node" i "}|"
+    print m
+    for (i = 0; i < m; i++) {
+        a = i % n; b = (a + 1 + int(i / n)) % n
+        print a+1 " " b+1 " 0 |{}|"
+    }
+}' > $dir/big.gw
+
+echo "Running SANA graph loading benchmark"
+
+for format in el gw; do
+    for sana in $binaries; do
+        time=`printedTime "Graph loading completed in" $sana -fg1 $dir/big.$format -fg2 $dir/big.$format -ec 1 -t 0.01 -o $dir/out`
+        echo "$format $sana: $time"
+    done
+done
+
+rm -rf $dir
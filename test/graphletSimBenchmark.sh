@@ -0,0 +1,23 @@
+#!/bin/bash
+
+# Compares how long SANA builds take to build the graphlet-based similarity
+# matrices (graphlet, graphletlgraal, graphletcosine) for yeast and human.
+# Usage: see test/benchmarkCommon.sh
+# The graphlet degree vectors are cached in networks/*/autogenerated by a first
+# run so that only the matrix construction is timed.
+
+. `dirname $0`/benchmarkCommon.sh
+
+mkdir -p networks/yeast/autogenerated networks/human/autogenerated
+$first -g1 yeast -g2 human -graphlet 1 -t 0.01 -o graphlet_benchmark > /dev/null 2>&1
+
+echo "Running SANA graphlet similarity benchmark"
+
+for measure in graphlet graphletlgraal graphletcosine; do
+    for sana in $binaries; do
+        time=`printedTime "Loading binary sim matrix done" $sana -g1 yeast -g2 human -$measure 1 -t 0.01 -o graphlet_benchmark`
+        echo "$measure $sana: $time"
+    done
+done
+
+rm -f graphlet_benchmark.out graphlet_benchmark.align
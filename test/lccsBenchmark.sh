@@ -0,0 +1,29 @@
+#!/bin/bash
+
+# Compares the iteration rate of SANA builds when optimizing the node fraction
+# of the largest common connected subgraph (lccsn), whose incremental tracking
+# searches the pieces cut off by each move, with the rate of the same run
+# optimizing EC alone, and the lccs each run reaches.
+# Usage: see test/benchmarkCommon.sh
+
+. `dirname $0`/benchmarkCommon.sh
+
+declare -a objectives=(
+  "-ec 1"
+  "-ec 0.5 -lccsn 0.5"
+)
+
+echo "Running SANA largest common connected subgraph benchmark"
+
+for pair in "${pairs[@]}"; do
+    set -- $pair
+    for objective in "${objectives[@]}"; do
+        for sana in $binaries; do
+            rate=`iterationRate $sana -g1 $1 -g2 $2 $objective -t 0.1 -o lccs_benchmark`
+            lccs=`grep -a "^lccs:" lccs_benchmark.out | head -1`
+            echo "$1-$2 $objective $sana: $rate iterations per second, $lccs"
+        done
+    done
+done
+
+rm -f lccs_benchmark.out lccs_benchmark.align
@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# Measures how SANA's iteration rate scales with the number of local measures
+# in the objective. The local measures are summed into one similarity matrix
+# before the run, so a move costs the same with 1 or 4 of them.
+# Usage: see test/benchmarkCommon.sh
+
+. `dirname $0`/benchmarkCommon.sh
+
+common="
+  -seed 10000
+  -g1 yeast
+  -g2 human
+  -method sana
+  -tinitial 0.0005
+  -tdecay 5
+  -t 0.2
+  -o local_benchmark
+"
+
+declare -a configs=(
+  "-ec 0.5 -nodec 0.5"
+  "-ec 0.4 -nodec 0.3 -edgec 0.3"
+  "-ec 0.2 -nodec 0.2 -edgec 0.2 -noded 0.2 -edged 0.2"
+)
+declare -a labels=(1 2 4)
+
+echo "Running SANA local measures benchmark"
+
+for i in ${!configs[@]}; do
+    for sana in $binaries; do
+        rate=`iterationRate $sana $common ${configs[$i]}`
+        echo "${labels[$i]} local measure(s) $sana: $rate iterations per second"
+    done
+done
+
+rm -f local_benchmark.out local_benchmark.align
@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# Compares the iteration rate of SANA builds when optimizing shortest path
+# conservation, which is dominated by the O(n1) incremental SPC evaluation,
+# with the rate of the same run optimizing EC alone.
+# Usage: see test/benchmarkCommon.sh
+
+. `dirname $0`/benchmarkCommon.sh
+
+declare -a objectives=(
+  "-ec 1"
+  "-ec 0.5 -spc 0.5"
+)
+
+echo "Running SANA shortest path conservation benchmark"
+
+for pair in "${pairs[@]}"; do
+    set -- $pair
+    for objective in "${objectives[@]}"; do
+        for sana in $binaries; do
+            rate=`iterationRate $sana -g1 $1 -g2 $2 $objective $fixedSchedule -o spc_benchmark`
+            echo "$1-$2 $objective $sana: $rate iterations per second"
+        done
+    done
+done
+
+rm -f spc_benchmark.out spc_benchmark.align
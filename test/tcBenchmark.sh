@@ -0,0 +1,19 @@
+#!/bin/bash
+
+# Compares the iteration rate of SANA builds when optimizing triangle
+# correctness, which is dominated by the incremental TC evaluation.
+# Usage: see test/benchmarkCommon.sh
+
+. `dirname $0`/benchmarkCommon.sh
+
+echo "Running SANA triangle correctness benchmark"
+
+for pair in "${pairs[@]}"; do
+    set -- $pair
+    for sana in $binaries; do
+        rate=`iterationRate $sana -g1 $1 -g2 $2 -tc 1 $fixedSchedule -o tc_benchmark`
+        echo "$1-$2 $sana: $rate iterations per second"
+    done
+done
+
+rm -f tc_benchmark.out tc_benchmark.align